@@ -0,0 +1,177 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <ygm/collective.hpp>
+#include <ygm/comm.hpp>
+
+///
+/// Binary array files.  A fixed 32-byte header followed by the raw elements,
+/// so a file can be memory-mapped and iterated in place without parsing.
+///
+
+// Elements are copied to and from files bitwise.  std::pair has a
+// user-provided assignment operator, so std::is_trivially_copyable is too
+// strict for edge lists.
+template <typename T>
+constexpr bool is_bitwise_copyable_v =
+    std::is_trivially_copy_constructible_v<T> &&
+    std::is_trivially_destructible_v<T>;
+
+struct binary_array_header {
+  static constexpr uint64_t s_magic = 0x59525241424d4759;  // "YGMBARRY"
+
+  uint64_t magic;
+  uint64_t element_size;
+  uint64_t count;
+  uint64_t reserved;
+};
+
+/// Writes elements to path.  Data goes to a temporary file that is renamed
+/// into place, so concurrent readers never see a partially written file.
+/// Returns false on any I/O error.
+template <typename T>
+bool write_binary_array(const std::string &path, std::span<const T> elements) {
+  static_assert(is_bitwise_copyable_v<T>);
+
+  binary_array_header header{binary_array_header::s_magic, sizeof(T),
+                             elements.size(), 0};
+
+  std::error_code ec;
+  std::filesystem::create_directories(
+      std::filesystem::path(path).parent_path(), ec);
+
+  std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream ofs(tmp_path, std::ios::binary | std::ios::trunc);
+    ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    ofs.write(reinterpret_cast<const char *>(elements.data()),
+              elements.size_bytes());
+    if (!ofs) {
+      std::remove(tmp_path.c_str());
+      return false;
+    }
+  }
+
+  return std::rename(tmp_path.c_str(), path.c_str()) == 0;
+}
+
+/// Read-only memory mapping of a file written by write_binary_array().
+/// Elements are accessed in place through data(), without copies.
+template <typename T>
+class mapped_binary_array {
+ public:
+  static_assert(is_bitwise_copyable_v<T>);
+
+  mapped_binary_array() = default;
+
+  mapped_binary_array(const mapped_binary_array &) = delete;
+  mapped_binary_array &operator=(const mapped_binary_array &) = delete;
+
+  ~mapped_binary_array() { close(); }
+
+  /// Maps path, prefaulting all pages so the cost of reading the file is paid
+  /// here rather than during iteration.  Returns false if the file is missing
+  /// or was not written for elements of type T.
+  bool open(const std::string &path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        st.st_size < (off_t)sizeof(binary_array_header)) {
+      ::close(fd);
+      return false;
+    }
+
+    void *addr =
+        mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+      return false;
+    }
+
+    m_addr     = addr;
+    m_map_size = st.st_size;
+
+    binary_array_header header;
+    std::memcpy(&header, m_addr, sizeof(header));
+    if (header.magic != binary_array_header::s_magic ||
+        header.element_size != sizeof(T) ||
+        header.count * sizeof(T) != m_map_size - sizeof(header)) {
+      close();
+      return false;
+    }
+
+    m_data = std::span<const T>(
+        reinterpret_cast<const T *>(static_cast<const char *>(m_addr) +
+                                    sizeof(header)),
+        header.count);
+
+    return true;
+  }
+
+  void close() {
+    if (m_addr != nullptr) {
+      munmap(m_addr, m_map_size);
+    }
+    m_addr     = nullptr;
+    m_map_size = 0;
+    m_data     = std::span<const T>();
+  }
+
+  bool is_open() const { return m_addr != nullptr; }
+
+  std::span<const T> data() const { return m_data; }
+
+  /// Number of bytes mapped, including the header
+  size_t size_bytes() const { return m_map_size; }
+
+ private:
+  void              *m_addr{nullptr};
+  size_t             m_map_size{0};
+  std::span<const T> m_data;
+};
+
+/// Path of this rank's file in a cache directory.  The key must describe
+/// everything that determines the cached data other than the rank count,
+/// which is appended here.
+std::string binary_array_cache_path(ygm::comm &world, const std::string &dir,
+                                    const std::string &key) {
+  return dir + "/" + key + "_P" + std::to_string(world.size()) + "_R" +
+         std::to_string(world.rank()) + ".bin";
+}
+
+/// Collectively maps this rank's cache file.  Succeeds only if every rank's
+/// file is valid, so that all ranks either load or regenerate together.
+template <typename T>
+bool open_binary_array_cache(ygm::comm &world, const std::string &path,
+                             mapped_binary_array<T> &mapped) {
+  bool hit = ygm::logical_and(mapped.open(path), world);
+  if (!hit) {
+    mapped.close();
+  }
+
+  return hit;
+}
@@ -0,0 +1,196 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <ygm/collective.hpp>
+#include <ygm/comm.hpp>
+#include <ygm/utility/timer.hpp>
+
+///
+/// Bulk-synchronous histogram, the baseline for YGM's asynchronous
+/// reductions.  All insertions of a step are sorted, combined, exchanged in a
+/// single MPI_Alltoallv and added to block-partitioned local counts.
+///
+
+struct bulk_histogram_stats {
+  double   sort_time;
+  double   exchange_time;
+  double   aggregate_time;
+  uint64_t sent_pairs;
+  uint64_t sent_bytes;
+};
+
+/// Counts are stored as Count and exchanged as (Key, Count) pairs, so narrow
+/// types reduce the bytes sent
+template <typename Key, typename Count>
+class bulk_histogram {
+ public:
+  using key_type   = Key;
+  using count_type = Count;
+  using count_pair = std::pair<Key, Count>;
+
+  /// Index i is owned by rank i / block_size, like a block-partitioned array
+  struct block_partitioner {
+    uint64_t block_size;
+
+    int owner(const uint64_t index) const { return index / block_size; }
+  };
+
+  bulk_histogram(ygm::comm &world, const uint64_t table_size)
+      : partitioner{(table_size + world.size() - 1) / world.size()},
+        m_world(world),
+        m_table_size(table_size) {
+    m_local_begin = std::min<uint64_t>(table_size,
+                                       world.rank() * partitioner.block_size);
+    m_counts.resize(std::min<uint64_t>(table_size - m_local_begin,
+                                       partitioner.block_size));
+  }
+
+  /// Zeroes all counts
+  void clear() { std::fill(m_counts.begin(), m_counts.end(), Count(0)); }
+
+  /// Calls fn(index, count) on the locally owned counts
+  template <typename Function>
+  void for_all(Function fn) {
+    for (uint64_t i = 0; i < m_counts.size(); ++i) {
+      fn(m_local_begin + i, m_counts[i]);
+    }
+  }
+
+  /// Collectively adds one to the count of every index in indices
+  bulk_histogram_stats count(std::span<const uint64_t> indices) {
+    bulk_histogram_stats stats{};
+
+    // Sorting by index also groups indices by owner, since owners hold
+    // contiguous blocks
+    ygm::utility::timer sort_timer{};
+    radix_sort(indices);
+    std::vector<count_pair> pairs;
+    std::vector<uint64_t>   send_counts(m_world.size(), 0);
+    for (uint64_t i = 0; i < m_sorted.size(); ++i) {
+      if (pairs.empty() || pairs.back().first != m_sorted[i]) {
+        pairs.emplace_back(Key(m_sorted[i]), Count(0));
+        send_counts[partitioner.owner(m_sorted[i])] += sizeof(count_pair);
+      }
+      ++pairs.back().second;
+    }
+    stats.sort_time = sort_timer.elapsed();
+
+    ygm::utility::timer     exchange_timer{};
+    std::vector<count_pair> received = exchange(pairs, send_counts);
+    stats.exchange_time              = exchange_timer.elapsed();
+
+    ygm::utility::timer aggregate_timer{};
+    for (const auto &[index, count] : received) {
+      m_counts[index - m_local_begin] += count;
+    }
+    stats.aggregate_time = aggregate_timer.elapsed();
+
+    stats.sent_pairs = pairs.size();
+    stats.sent_bytes = pairs.size() * sizeof(count_pair);
+
+    return stats;
+  }
+
+  block_partitioner partitioner;
+
+ private:
+  // LSD radix sort of indices into m_sorted, 8 bits per pass over the bits
+  // of the largest index
+  void radix_sort(std::span<const uint64_t> indices) {
+    constexpr int radix_bits = 8;
+    constexpr int radix      = 1 << radix_bits;
+
+    int key_bits = 0;
+    while (key_bits < 64 && (m_table_size - 1) >> key_bits) {
+      ++key_bits;
+    }
+
+    m_sorted.assign(indices.begin(), indices.end());
+    m_buffer.resize(indices.size());
+
+    for (int shift = 0; shift < key_bits; shift += radix_bits) {
+      std::vector<uint64_t> offsets(radix + 1, 0);
+      for (const auto index : m_sorted) {
+        ++offsets[((index >> shift) & (radix - 1)) + 1];
+      }
+      for (int digit = 0; digit < radix; ++digit) {
+        offsets[digit + 1] += offsets[digit];
+      }
+      for (const auto index : m_sorted) {
+        m_buffer[offsets[(index >> shift) & (radix - 1)]++] = index;
+      }
+      m_sorted.swap(m_buffer);
+    }
+  }
+
+  // Sends pairs to their owners, given the number of bytes destined for each
+  // rank.  Counts and displacements must fit the int arguments of
+  // MPI_Alltoallv.  Ranks agree on whether they do before any rank exits, so
+  // none is left waiting in the exchange.
+  std::vector<count_pair> exchange(const std::vector<count_pair> &pairs,
+                                   const std::vector<uint64_t>   &send_bytes) {
+    MPI_Comm comm = m_world.get_mpi_comm();
+    int      size = m_world.size();
+
+    // Each send count is at most the total, so none overflows unless it does
+    bool overflow =
+        pairs.size() * sizeof(count_pair) > std::numeric_limits<int>::max();
+    std::vector<int> send_counts(send_bytes.begin(), send_bytes.end());
+
+    std::vector<int> recv_counts(size);
+    MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1,
+                 MPI_INT, comm);
+
+    uint64_t total_recv{0};
+    for (const int count : recv_counts) {
+      total_recv += count;
+    }
+    overflow = overflow || total_recv > std::numeric_limits<int>::max();
+    if (ygm::logical_or(overflow, m_world)) {
+      m_world.cerr0() << "bulk_histogram exchange exceeds MPI_Alltoallv counts"
+                      << std::endl;
+      exit(-1);
+    }
+
+    std::vector<int> send_displs(size, 0);
+    std::vector<int> recv_displs(size, 0);
+    for (int rank = 1; rank < size; ++rank) {
+      send_displs[rank] = send_displs[rank - 1] + send_counts[rank - 1];
+      recv_displs[rank] = recv_displs[rank - 1] + recv_counts[rank - 1];
+    }
+
+    std::vector<count_pair> received(total_recv / sizeof(count_pair));
+    MPI_Alltoallv(pairs.data(), send_counts.data(), send_displs.data(),
+                  MPI_BYTE, received.data(), recv_counts.data(),
+                  recv_displs.data(), MPI_BYTE, comm);
+
+    return received;
+  }
+
+  ygm::comm            &m_world;
+  uint64_t              m_table_size;
+  uint64_t              m_local_begin;
+  std::vector<Count>    m_counts;
+  std::vector<uint64_t> m_sorted;
+  std::vector<uint64_t> m_buffer;
+};
+
+template <typename T>
+constexpr bool is_bulk_histogram_v = false;
+
+template <typename Key, typename Count>
+constexpr bool is_bulk_histogram_v<bulk_histogram<Key, Count>> = true;
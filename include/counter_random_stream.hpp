@@ -0,0 +1,50 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <bit>
+
+#include <stdint.h>
+
+///
+/// Counter-based random numbers
+///
+
+/// SplitMix64 finalizer.  A bijection on 64-bit integers with good avalanche
+/// behavior, used as the core of the counter-based random streams below.
+inline uint64_t splitmix64_mix(uint64_t z) {
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return z ^ (z >> 31);
+}
+
+/// Counter-based random stream.  The k-th value drawn from the stream for
+/// (seed, counter) depends only on (seed, counter, k), so any stream can be
+/// constructed directly without generating the streams before it.
+class counter_random_stream {
+ public:
+  counter_random_stream() : m_state(0) {}
+
+  counter_random_stream(uint64_t seed, uint64_t counter)
+      : m_state(splitmix64_mix(splitmix64_mix(seed) + counter * s_gamma)) {}
+
+  uint64_t next() {
+    m_state += s_gamma;
+    return splitmix64_mix(m_state);
+  }
+
+  /// Uniform double in [0, 1) using the upper 52 bits of the next value.
+  /// Built from a shift and a bit cast, rather than an integer conversion, so
+  /// that it vectorizes on targets without 64-bit integer conversions.
+  double next_double() {
+    return std::bit_cast<double>((next() >> 12) | 0x3ff0000000000000) - 1.0;
+  }
+
+ private:
+  static constexpr uint64_t s_gamma = 0x9e3779b97f4a7c15;
+
+  uint64_t m_state;
+};
@@ -0,0 +1,275 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <ygm/collective.hpp>
+#include <ygm/comm.hpp>
+
+///
+/// Connected components algorithms to compare with ygm's disjoint_set.  Edges
+/// are sent to the owners of both endpoints, which store each vertex's
+/// neighbors, and components are labeled by their smallest vertex.  Like
+/// disjoint_set, only vertices of edges are labeled.
+///
+
+/// Vertex v is owned by rank v % size
+struct cyclic_partitioner {
+  int size;
+
+  int owner(const uint64_t v) const { return v % size; }
+};
+
+/// FastSV (Zhang, Azad and Hu, 2020), a Shiloach-Vishkin variant.  Each
+/// iteration hooks trees onto smaller grandparents across edges, shortcuts
+/// every vertex to its grandparent and finishes when no grandparent changes.
+/// Iterations are bulk synchronous; the messages within each are
+/// asynchronous.
+class fastsv_cc {
+ public:
+  explicit fastsv_cc(ygm::comm &world)
+      : partitioner{world.size()},
+        m_world(world),
+        m_pthis(world.make_ygm_ptr(*this)) {}
+
+  fastsv_cc(const fastsv_cc &) = delete;
+  fastsv_cc &operator=(const fastsv_cc &) = delete;
+
+  void async_add_edge(const uint64_t first, const uint64_t second) {
+    auto add_neighbor = [](auto pthis, const uint64_t v, const uint64_t u) {
+      vertex_state &vertex = pthis->local_vertex(v);
+      if (u != v) {
+        vertex.neighbors.push_back(u);
+      }
+    };
+    m_world.async(partitioner.owner(first), add_neighbor, m_pthis, first,
+                  second);
+    if (first != second) {
+      m_world.async(partitioner.owner(second), add_neighbor, m_pthis, second,
+                    first);
+    }
+  }
+
+  /// Collectively labels the components of the edges added so far
+  void run() {
+    m_world.barrier();
+
+    m_iterations = 0;
+    bool converged{false};
+    while (!converged) {
+      hook();
+      shortcut();
+      // Parents are read remotely next, so every rank must finish shortcut()
+      m_world.barrier();
+      converged = ygm::logical_and(!update_grandparents(), m_world);
+      ++m_iterations;
+    }
+  }
+
+  /// Calls fn(vertex, label) on each locally owned vertex
+  template <typename Function>
+  void for_all(Function fn) {
+    for (const auto &[v, vertex] : m_vertices) {
+      fn(v, vertex.parent);
+    }
+  }
+
+  uint64_t iterations() const { return m_iterations; }
+
+  cyclic_partitioner partitioner;
+
+ private:
+  struct vertex_state {
+    uint64_t              parent;
+    uint64_t              grandparent;
+    uint64_t              old_parent;
+    std::vector<uint64_t> neighbors;
+  };
+
+  vertex_state &local_vertex(const uint64_t v) {
+    auto [itr, inserted] = m_vertices.try_emplace(v);
+    if (inserted) {
+      itr->second.parent      = v;
+      itr->second.grandparent = v;
+    }
+    return itr->second;
+  }
+
+  static void lower(uint64_t &value, const uint64_t candidate) {
+    if (candidate < value) {
+      value = candidate;
+    }
+  }
+
+  // Stochastic hooking sets f[f[u]] and aggressive hooking sets f[u] to the
+  // grandparent of any neighbor v of u, if smaller.  Parents never exceed
+  // their vertex, so only grandparents smaller than u are sent.
+  void hook() {
+    for (auto &[v, vertex] : m_vertices) {
+      vertex.old_parent = vertex.parent;
+    }
+    m_world.barrier();
+
+    auto hook_vertex = [](auto pthis, const uint64_t u, const uint64_t g) {
+      auto hook_parent = [](auto pthis, const uint64_t v, const uint64_t g) {
+        lower(pthis->m_vertices.at(v).parent, g);
+      };
+
+      vertex_state &vertex = pthis->m_vertices.at(u);
+      lower(vertex.parent, g);
+      if (g < vertex.old_parent) {
+        pthis->m_world.async(pthis->partitioner.owner(vertex.old_parent),
+                             hook_parent, pthis, vertex.old_parent, g);
+      }
+    };
+
+    for (const auto &[v, vertex] : m_vertices) {
+      for (const auto u : vertex.neighbors) {
+        if (vertex.grandparent < u) {
+          m_world.async(partitioner.owner(u), hook_vertex, m_pthis, u,
+                        vertex.grandparent);
+        }
+      }
+    }
+    m_world.barrier();
+  }
+
+  void shortcut() {
+    for (auto &[v, vertex] : m_vertices) {
+      lower(vertex.parent, vertex.grandparent);
+    }
+  }
+
+  // Fetches the parent of every vertex's parent.  Returns true if any local
+  // grandparent changed.
+  bool update_grandparents() {
+    auto get_parent = [](auto pthis, const uint64_t p, const uint64_t v,
+                         const int from) {
+      auto set_grandparent = [](auto pthis, const uint64_t v,
+                                const uint64_t g) {
+        vertex_state &vertex = pthis->m_vertices.at(v);
+        if (vertex.grandparent != g) {
+          vertex.grandparent          = g;
+          pthis->m_grandparent_changed = true;
+        }
+      };
+
+      pthis->m_world.async(from, set_grandparent, pthis, v,
+                           pthis->m_vertices.at(p).parent);
+    };
+
+    m_grandparent_changed = false;
+    for (const auto &[v, vertex] : m_vertices) {
+      m_world.async(partitioner.owner(vertex.parent), get_parent, m_pthis,
+                    vertex.parent, v, m_world.rank());
+    }
+    m_world.barrier();
+
+    return m_grandparent_changed;
+  }
+
+  ygm::comm                                 &m_world;
+  ygm::ygm_ptr<fastsv_cc>                    m_pthis;
+  std::unordered_map<uint64_t, vertex_state> m_vertices;
+  uint64_t                                   m_iterations{0};
+  bool                                       m_grandparent_changed{false};
+};
+
+/// Asynchronous min-label propagation.  Every vertex offers its label to its
+/// neighbors and each vertex whose label drops passes it on, until no message
+/// is in flight.  A path of n vertices may take n - 1 sequential messages.
+class label_propagation_cc {
+ public:
+  explicit label_propagation_cc(ygm::comm &world)
+      : partitioner{world.size()},
+        m_world(world),
+        m_pthis(world.make_ygm_ptr(*this)) {}
+
+  label_propagation_cc(const label_propagation_cc &) = delete;
+  label_propagation_cc &operator=(const label_propagation_cc &) = delete;
+
+  void async_add_edge(const uint64_t first, const uint64_t second) {
+    auto add_neighbor = [](auto pthis, const uint64_t v, const uint64_t u) {
+      vertex_state &vertex = pthis->local_vertex(v);
+      if (u != v) {
+        vertex.neighbors.push_back(u);
+      }
+    };
+    m_world.async(partitioner.owner(first), add_neighbor, m_pthis, first,
+                  second);
+    if (first != second) {
+      m_world.async(partitioner.owner(second), add_neighbor, m_pthis, second,
+                    first);
+    }
+  }
+
+  /// Collectively labels the components of the edges added so far
+  void run() {
+    m_world.barrier();
+
+    m_label_updates = 0;
+    for (const auto &[v, vertex] : m_vertices) {
+      offer_label(vertex);
+    }
+    m_world.barrier();
+  }
+
+  /// Calls fn(vertex, label) on each locally owned vertex
+  template <typename Function>
+  void for_all(Function fn) {
+    for (const auto &[v, vertex] : m_vertices) {
+      fn(v, vertex.label);
+    }
+  }
+
+  /// Labels lowered on this rank by the last run()
+  uint64_t label_updates() const { return m_label_updates; }
+
+  cyclic_partitioner partitioner;
+
+ private:
+  struct vertex_state {
+    uint64_t              label;
+    std::vector<uint64_t> neighbors;
+  };
+
+  vertex_state &local_vertex(const uint64_t v) {
+    auto [itr, inserted] = m_vertices.try_emplace(v);
+    if (inserted) {
+      itr->second.label = v;
+    }
+    return itr->second;
+  }
+
+  // Labels never exceed their vertex, so only neighbors larger than the
+  // label can be lowered by it
+  void offer_label(const vertex_state &vertex) {
+    auto receive_label = [](auto pthis, const uint64_t v,
+                            const uint64_t label) {
+      vertex_state &vertex = pthis->m_vertices.at(v);
+      if (label < vertex.label) {
+        vertex.label = label;
+        ++pthis->m_label_updates;
+        pthis->offer_label(vertex);
+      }
+    };
+
+    uint64_t label = vertex.label;
+    for (const auto u : vertex.neighbors) {
+      if (label < u) {
+        m_world.async(partitioner.owner(u), receive_label, m_pthis, u, label);
+      }
+    }
+  }
+
+  ygm::comm                                 &m_world;
+  ygm::ygm_ptr<label_propagation_cc>         m_pthis;
+  std::unordered_map<uint64_t, vertex_state> m_vertices;
+  uint64_t                                   m_label_updates{0};
+};
@@ -0,0 +1,222 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <binary_array_file.hpp>
+#include <ygm/comm.hpp>
+
+///
+/// Parallel edge-list ingestion.  Every rank reads a disjoint byte range of
+/// the input files, so no rank holds more than its share of the graph.
+///
+
+enum class edge_list_format { text, binary };
+
+/// Regular files at path, which may be a file or a directory.  Sorted so all
+/// ranks see the same list in the same order.
+std::vector<std::string> edge_list_files(const std::string &path) {
+  std::vector<std::string> files;
+
+  if (std::filesystem::is_directory(path)) {
+    for (const auto &entry : std::filesystem::directory_iterator(path)) {
+      if (entry.is_regular_file()) {
+        files.push_back(entry.path().string());
+      }
+    }
+    std::sort(files.begin(), files.end());
+  } else {
+    files.push_back(path);
+  }
+
+  return files;
+}
+
+/// Total size of files in bytes
+uint64_t edge_list_bytes(const std::vector<std::string> &files) {
+  uint64_t bytes{0};
+  for (const auto &file : files) {
+    bytes += std::filesystem::file_size(file);
+  }
+
+  return bytes;
+}
+
+/// Parses the first two whitespace-separated integers of a line.  Returns false
+/// for blank lines, comments ('#' in SNAP files, '%' in Matrix Market files)
+/// and lines that do not start with two vertex IDs.
+inline bool parse_edge_line(const std::string &line, uint64_t &source,
+                            uint64_t &target) {
+  const char *pos = line.data();
+  const char *end = line.data() + line.size();
+
+  auto skip_space = [&pos, end]() {
+    while (pos != end && (*pos == ' ' || *pos == '\t' || *pos == ',' ||
+                          *pos == '\r')) {
+      ++pos;
+    }
+  };
+
+  skip_space();
+  if (pos == end || *pos == '#' || *pos == '%') {
+    return false;
+  }
+
+  auto [source_end, source_ec] = std::from_chars(pos, end, source);
+  if (source_ec != std::errc()) {
+    return false;
+  }
+  pos = source_end;
+
+  skip_space();
+  return std::from_chars(pos, end, target).ec == std::errc();
+}
+
+/// Byte offset of the "rows cols entries" line following the banner and
+/// comments of a Matrix Market file, or -1 for other files.  Entries may repeat
+/// its text, so it is skipped by position.
+int64_t matrix_market_size_offset(const std::string &file) {
+  std::ifstream ifs(file);
+  std::string   line;
+
+  if (!std::getline(ifs, line) || line.rfind("%%MatrixMarket", 0) != 0) {
+    return -1;
+  }
+
+  int64_t offset = ifs.tellg();
+  while (std::getline(ifs, line)) {
+    if (!line.empty() && line[0] != '%') {
+      return offset;
+    }
+    offset = ifs.tellg();
+  }
+
+  return -1;
+}
+
+/// Calls fn(source, target) on the edges of the lines of file that start in
+/// bytes [begin, end)
+template <typename Function>
+void for_all_text_edges_in_range(const std::string &file, const uint64_t begin,
+                                 const uint64_t end, Function fn) {
+  std::ifstream ifs(file);
+  std::string   line;
+  int64_t       size_offset = matrix_market_size_offset(file);
+
+  // The line holding byte begin - 1 belongs to the range before this one
+  uint64_t pos = begin;
+  if (begin > 0) {
+    ifs.seekg(begin - 1);
+    std::getline(ifs, line);
+    pos = begin + line.size();
+  }
+
+  while (pos < end && std::getline(ifs, line)) {
+    uint64_t source;
+    uint64_t target;
+    if (int64_t(pos) != size_offset && parse_edge_line(line, source, target)) {
+      fn(source, target);
+    }
+    pos += line.size() + 1;
+  }
+}
+
+/// Calls fn(source, target) on this rank's share of the edges in text files.
+/// The files are split into contiguous byte ranges, one per rank, and each
+/// line is read by the rank whose range holds its first byte.  Columns after
+/// the first two, such as weights, are ignored.
+template <typename Function>
+void for_all_text_edges(ygm::comm &world, const std::vector<std::string> &files,
+                        Function fn) {
+  uint64_t total_bytes    = edge_list_bytes(files);
+  uint64_t min_range_size = total_bytes / world.size();
+  uint64_t range_begin =
+      world.rank() * min_range_size +
+      std::min<uint64_t>(world.rank(), total_bytes % world.size());
+  uint64_t range_end =
+      range_begin + min_range_size +
+      (uint64_t(world.rank()) < total_bytes % world.size());
+
+  uint64_t file_begin{0};
+  for (const auto &file : files) {
+    uint64_t file_end = file_begin + std::filesystem::file_size(file);
+    if (file_begin < range_end && range_begin < file_end) {
+      for_all_text_edges_in_range(
+          file, std::max(range_begin, file_begin) - file_begin,
+          std::min(range_end, file_end) - file_begin, fn);
+    }
+    file_begin = file_end;
+  }
+}
+
+/// Calls fn(source, target) on this rank's share of the edges in binary files
+/// of native-endian uint64_t pairs.  Files written by write_binary_array(),
+/// such as the cc_ygm edge cache, are recognized by their header.  Each file
+/// is split into contiguous blocks of edges, one per rank.
+template <typename Function>
+void for_all_binary_edges(ygm::comm                      &world,
+                          const std::vector<std::string> &files, Function fn) {
+  using edge_type = std::pair<uint64_t, uint64_t>;
+
+  std::vector<edge_type> buffer(4096);
+
+  for (const auto &file : files) {
+    std::ifstream ifs(file, std::ios::binary);
+
+    uint64_t data_offset{0};
+    uint64_t num_edges = std::filesystem::file_size(file) / sizeof(edge_type);
+
+    binary_array_header header;
+    if (ifs.read(reinterpret_cast<char *>(&header), sizeof(header)) &&
+        header.magic == binary_array_header::s_magic &&
+        header.element_size == sizeof(edge_type)) {
+      data_offset = sizeof(header);
+      num_edges   = header.count;
+    }
+
+    uint64_t min_block_size = num_edges / world.size();
+    uint64_t local_edges =
+        min_block_size + (uint64_t(world.rank()) < num_edges % world.size());
+    uint64_t first_edge =
+        world.rank() * min_block_size +
+        std::min<uint64_t>(world.rank(), num_edges % world.size());
+
+    ifs.clear();
+    ifs.seekg(data_offset + first_edge * sizeof(edge_type));
+    for (uint64_t i = 0; i < local_edges; i += buffer.size()) {
+      uint64_t count = std::min<uint64_t>(buffer.size(), local_edges - i);
+      ifs.read(reinterpret_cast<char *>(buffer.data()),
+               count * sizeof(edge_type));
+      if (!ifs) {
+        std::cerr << "Failed to read edges from " << file << std::endl;
+        exit(-1);
+      }
+      for (uint64_t j = 0; j < count; ++j) {
+        fn(buffer[j].first, buffer[j].second);
+      }
+    }
+  }
+}
+
+/// Calls fn(source, target) on this rank's share of the edges in files
+template <typename Function>
+void for_all_file_edges(ygm::comm &world, const std::vector<std::string> &files,
+                        const edge_list_format format, Function fn) {
+  if (format == edge_list_format::binary) {
+    for_all_binary_edges(world, files, fn);
+  } else {
+    for_all_text_edges(world, files, fn);
+  }
+}
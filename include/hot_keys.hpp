@@ -0,0 +1,112 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <ygm/comm.hpp>
+
+///
+/// Hot-key replication for skewed reductions.  The most frequent keys are
+/// found from a sample, every rank accumulates updates to them locally, and
+/// the partial counts are merged into their owners once at the end.
+///
+
+/// Collectively finds up to num_keys of the most frequent keys.  sample(fn)
+/// must call fn(key) for each key in this rank's sample.  Every rank returns
+/// the same keys, most frequent first.
+template <typename SampleFunction>
+std::vector<uint64_t> find_hot_keys(ygm::comm &world, const uint64_t num_keys,
+                                    SampleFunction sample) {
+  using key_count = std::pair<uint64_t, uint64_t>;
+
+  std::unordered_map<uint64_t, uint64_t> local_counts;
+  sample([&local_counts](const uint64_t key) { ++local_counts[key]; });
+
+  // Each rank nominates its num_keys most frequent sampled keys.  Unused
+  // entries have a count of 0.
+  std::vector<key_count> candidates(local_counts.begin(), local_counts.end());
+  auto by_count = [](const key_count &lhs, const key_count &rhs) {
+    return lhs.second > rhs.second ||
+           (lhs.second == rhs.second && lhs.first < rhs.first);
+  };
+  uint64_t num_local = std::min<uint64_t>(num_keys, candidates.size());
+  std::partial_sort(candidates.begin(), candidates.begin() + num_local,
+                    candidates.end(), by_count);
+  candidates.resize(num_keys, key_count{0, 0});
+
+  std::vector<key_count> all_candidates(num_keys * world.size());
+  MPI_Allgather(candidates.data(), 2 * num_keys, MPI_UINT64_T,
+                all_candidates.data(), 2 * num_keys, MPI_UINT64_T,
+                world.get_mpi_comm());
+
+  std::map<uint64_t, uint64_t> global_counts;
+  for (const auto &[key, count] : all_candidates) {
+    if (count > 0) {
+      global_counts[key] += count;
+    }
+  }
+
+  std::vector<key_count> ranked(global_counts.begin(), global_counts.end());
+  std::sort(ranked.begin(), ranked.end(), by_count);
+
+  std::vector<uint64_t> hot_keys;
+  for (uint64_t i = 0; i < std::min<uint64_t>(num_keys, ranked.size()); ++i) {
+    hot_keys.push_back(ranked[i].first);
+  }
+
+  return hot_keys;
+}
+
+/// Local counters for replicated keys
+class hot_key_table {
+ public:
+  hot_key_table() = default;
+
+  explicit hot_key_table(const std::vector<uint64_t> &keys) {
+    for (const auto key : keys) {
+      m_counts[key] = 0;
+    }
+  }
+
+  size_t size() const { return m_counts.size(); }
+
+  bool empty() const { return m_counts.empty(); }
+
+  bool contains(const uint64_t key) const { return m_counts.count(key) > 0; }
+
+  /// Adds count to key's counter.  Returns false, changing nothing, if key is
+  /// not hot.
+  bool add(const uint64_t key, const uint64_t count = 1) {
+    auto itr = m_counts.find(key);
+    if (itr == m_counts.end()) {
+      return false;
+    }
+    itr->second += count;
+    return true;
+  }
+
+  /// Calls fn(key, count) on each nonzero counter and zeroes it
+  template <typename Function>
+  void flush(Function fn) {
+    for (auto &[key, count] : m_counts) {
+      if (count > 0) {
+        fn(key, count);
+        count = 0;
+      }
+    }
+  }
+
+ private:
+  std::unordered_map<uint64_t, uint64_t> m_counts;
+};
@@ -0,0 +1,79 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdint.h>
+
+///
+/// The random sequence of the HPCC RandomAccess benchmark, a primitive
+/// polynomial over GF(2) stepped by shifts, so results are comparable with
+/// published HPCC GUPS numbers
+///
+
+/// Stream starting at any position of the HPCC sequence.  The first value
+/// drawn at position n is the value HPCC uses for global update n.
+class hpcc_random_stream {
+ public:
+  explicit hpcc_random_stream(int64_t n) : m_state(starts(n)) {}
+
+  uint64_t next() {
+    m_state = step(m_state);
+    return m_state;
+  }
+
+ private:
+  static constexpr uint64_t s_poly   = 0x0000000000000007;
+  static constexpr int64_t  s_period = 1317624576693539401;
+
+  static uint64_t step(const uint64_t ran) {
+    return (ran << 1) ^ (int64_t(ran) < 0 ? s_poly : 0);
+  }
+
+  // HPCC_starts(): the state preceding position n, found by repeated squaring
+  // of the step in GF(2)
+  static uint64_t starts(int64_t n) {
+    while (n < 0) {
+      n += s_period;
+    }
+    while (n > s_period) {
+      n -= s_period;
+    }
+    if (n == 0) {
+      return 0x1;
+    }
+
+    uint64_t m2[64];
+    uint64_t temp = 0x1;
+    for (int i = 0; i < 64; ++i) {
+      m2[i] = temp;
+      temp  = step(step(temp));
+    }
+
+    int i = 62;
+    while (i >= 0 && !((n >> i) & 1)) {
+      --i;
+    }
+
+    uint64_t ran = 0x2;
+    while (i > 0) {
+      temp = 0;
+      for (int j = 0; j < 64; ++j) {
+        if ((ran >> j) & 1) {
+          temp ^= m2[j];
+        }
+      }
+      ran = temp;
+      --i;
+      if ((n >> i) & 1) {
+        ran = step(ran);
+      }
+    }
+
+    return ran;
+  }
+
+  uint64_t m_state;
+};
@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include <rmat_edge_generator.hpp>
 #include <utility.hpp>
 
 #include <krowkee/sketch/interface.hpp>
@@ -46,6 +47,8 @@ struct parameters_t {
   bool      rmat;
   bool      pretty_print;
 
+  rmat_parameters rmat_params;
+
   parameters_t()
       : range_size(8),
         log_vertex_count(20),
@@ -68,6 +71,11 @@ void usage(ygm::comm &comm) {
       << "\n\t-t <int>\t- Number of trials"
       << "\n\t-s <int>\t- Seed"
       << "\n\t-r\t\t- Flag indicating insertions should use RMAT generator"
+      << "\n\t-R <str>\t- RMAT quadrant probabilities a,b,c,d (default "
+         "0.57,0.19,0.19,0.05)"
+      << "\n\t-S <str>\t- RMAT vertex scrambler (none, hash, feistel)"
+      << "\n\t-U\t\t- Undirected RMAT graph (each generated edge is "
+         "inserted in both directions)"
       << "\n\t-b\t\t- Flag to embed data"
       << "\n\t-m\t\t- Flag indicating streaming mode"
       << "\n\t-p\t\t- Pretty print output"
@@ -83,7 +91,7 @@ parameters_t parse_args(int argc, char **argv, ygm::comm &comm) {
   extern int opterr;
   opterr = 0;
 
-  while ((c = getopt(argc, argv, "d:v:e:t:s:mrbaph")) != -1) {
+  while ((c = getopt(argc, argv, "d:v:e:t:s:mrR:S:Ubaph")) != -1) {
     switch (c) {
       case 'h':
         prn_help = true;
@@ -109,6 +117,22 @@ parameters_t parse_args(int argc, char **argv, ygm::comm &comm) {
       case 'r':
         params.rmat = true;
         break;
+      case 'R':
+        if (!parse_rmat_probabilities(optarg, params.rmat_params)) {
+          comm.cerr0() << "Invalid RMAT probabilities: " << optarg
+                       << std::endl;
+          prn_help = true;
+        }
+        break;
+      case 'S':
+        if (!parse_rmat_scrambler(optarg, params.rmat_params)) {
+          comm.cerr0() << "Unrecognized scrambler: " << optarg << std::endl;
+          prn_help = true;
+        }
+        break;
+      case 'U':
+        params.rmat_params.undirected = true;
+        break;
       case 'b':
         params.embed = true;
         break;
@@ -167,6 +191,20 @@ void do_streaming_analysis(ygm::comm &world, MapType &vertex_map,
 
     output["INSERTS_PER_SECOND(BILLIONS)"].as_array().emplace_back(trial_rate);
 
+    // Each insertion is sent to the owner of its source vertex.  Counted on a
+    // regenerated copy of the edges so the timed loop is unchanged.
+    std::vector<uint64_t> sent_to_rank(world.size());
+    EdgeGeneratorType     count_stream(world, params, 0);
+    for (int i(0); i < params.local_edge_count; ++i) {
+      ++sent_to_rank[container_owner(vertex_map, count_stream().first)];
+    }
+    auto [max_receive_load, mean_receive_load] =
+        receive_load(world, sent_to_rank);
+
+    output["MAX_RANK_RECEIVE_LOAD"].as_array().emplace_back(max_receive_load);
+    output["RECEIVE_LOAD_IMBALANCE"].as_array().emplace_back(
+        max_receive_load / mean_receive_load);
+
     parse_stats(world, output);
   }
 }
@@ -189,6 +227,8 @@ std::cout << world.layout().node_size() << ", "
   output["NAME"]                         = "EMBED_YGM";
   output["TIME"]                         = boost::json::array();
   output["INSERTS_PER_SECOND(BILLIONS)"] = boost::json::array();
+  output["MAX_RANK_RECEIVE_LOAD"]        = boost::json::array();
+  output["RECEIVE_LOAD_IMBALANCE"]       = boost::json::array();
   output["GLOBAL_ASYNC_COUNT"]           = boost::json::array();
   output["GLOBAL_ISEND_COUNT"]           = boost::json::array();
   output["GLOBAL_ISEND_BYTES"]           = boost::json::array();
@@ -202,7 +242,13 @@ std::cout << world.layout().node_size() << ", "
   output["SEED"]   = params.seed;
   output["STREAM"] = params.stream;
   if (params.rmat) {
-    output["GENERATOR"] = "RMAT";
+    output["GENERATOR"]       = "RMAT";
+    output["RMAT_A"]          = params.rmat_params.a;
+    output["RMAT_B"]          = params.rmat_params.b;
+    output["RMAT_C"]          = params.rmat_params.c;
+    output["RMAT_D"]          = params.rmat_params.d;
+    output["RMAT_SCRAMBLER"]  = rmat_scrambler_name(params.rmat_params);
+    output["RMAT_UNDIRECTED"] = params.rmat_params.undirected;
   } else {
     output["GENERATOR"] = "UNIFORM";
   }
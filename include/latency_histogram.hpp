@@ -0,0 +1,148 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+///
+/// Latency measurement across ranks.  Timestamps from different ranks are
+/// made comparable with a per-rank clock offset, and latencies are counted in
+/// log-bucketed histograms that are cheap to update and to merge.
+///
+
+/// This rank's steady clock, in nanoseconds
+inline int64_t steady_clock_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+struct clock_offset {
+  int64_t offset_ns;  // Added to steady_clock_ns() to approximate rank 0's
+  int64_t rtt_ns;     // Round trip of the estimate, twice its error bound
+};
+
+/// Collectively estimates every rank's clock offset from rank 0 with
+/// Cristian's algorithm, keeping the fastest of num_rounds ping-pongs
+clock_offset estimate_clock_offset(MPI_Comm comm, const int num_rounds = 16) {
+  int rank;
+  int size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  clock_offset estimate{0, 0};
+  if (rank != 0) {
+    estimate.rtt_ns = std::numeric_limits<int64_t>::max();
+  }
+
+  for (int peer = 1; peer < size; ++peer) {
+    for (int round = 0; round < num_rounds; ++round) {
+      if (rank == 0) {
+        int64_t now;
+        MPI_Recv(&now, 1, MPI_INT64_T, peer, 0, comm, MPI_STATUS_IGNORE);
+        now = steady_clock_ns();
+        MPI_Send(&now, 1, MPI_INT64_T, peer, 0, comm);
+      } else if (rank == peer) {
+        int64_t root_time;
+        int64_t send_time = steady_clock_ns();
+        MPI_Send(&send_time, 1, MPI_INT64_T, 0, 0, comm);
+        MPI_Recv(&root_time, 1, MPI_INT64_T, 0, 0, comm, MPI_STATUS_IGNORE);
+        int64_t receive_time = steady_clock_ns();
+
+        if (receive_time - send_time < estimate.rtt_ns) {
+          estimate.rtt_ns    = receive_time - send_time;
+          estimate.offset_ns = root_time - (send_time + receive_time) / 2;
+        }
+      }
+    }
+  }
+
+  return estimate;
+}
+
+/// Percentiles reported by the benchmarks, with their JSON key suffixes
+inline const std::vector<std::pair<std::string, double>> latency_percentiles =
+    {{"P50", 0.5}, {"P90", 0.9}, {"P99", 0.99}, {"P999", 0.999}};
+
+/// Histogram of nanosecond latencies.  Each power of two is split into
+/// s_sub_buckets linear buckets, so a percentile is reported within 1 /
+/// s_sub_buckets of its true value.
+class latency_histogram {
+ public:
+  static constexpr int s_sub_bucket_bits = 3;
+  static constexpr int s_sub_buckets     = 1 << s_sub_bucket_bits;
+
+  latency_histogram() : m_counts(64 * s_sub_buckets, 0) {}
+
+  void add(const uint64_t ns) { ++m_counts[bucket(ns)]; }
+
+  void clear() { std::fill(m_counts.begin(), m_counts.end(), 0); }
+
+  /// Collectively replaces every rank's counts with their sum
+  void merge(MPI_Comm comm) {
+    MPI_Allreduce(MPI_IN_PLACE, m_counts.data(), m_counts.size(),
+                  MPI_UINT64_T, MPI_SUM, comm);
+  }
+
+  uint64_t count() const {
+    uint64_t total{0};
+    for (const auto c : m_counts) {
+      total += c;
+    }
+    return total;
+  }
+
+  /// Upper bound of the bucket holding the q-quantile, or 0 when empty
+  uint64_t percentile(const double q) const {
+    uint64_t total = count();
+    if (total == 0) {
+      return 0;
+    }
+
+    uint64_t target = std::max<uint64_t>(1, std::ceil(q * total));
+    uint64_t seen{0};
+    for (size_t b = 0; b < m_counts.size(); ++b) {
+      seen += m_counts[b];
+      if (seen >= target) {
+        return bucket_upper(b);
+      }
+    }
+    return bucket_upper(m_counts.size() - 1);
+  }
+
+ private:
+  // Values below s_sub_buckets have their own buckets.  Larger values are
+  // bucketed by their leading s_sub_bucket_bits + 1 bits.
+  static size_t bucket(const uint64_t ns) {
+    if (ns < s_sub_buckets) {
+      return ns;
+    }
+    int      shift = std::bit_width(ns) - 1 - s_sub_bucket_bits;
+    uint64_t sub   = (ns >> shift) & (s_sub_buckets - 1);
+    return (shift + 1) * s_sub_buckets + sub;
+  }
+
+  static uint64_t bucket_upper(const size_t b) {
+    if (b < s_sub_buckets) {
+      return b;
+    }
+    int      shift = b / s_sub_buckets - 1;
+    uint64_t sub   = b % s_sub_buckets;
+    return ((s_sub_buckets + sub + 1) << shift) - 1;
+  }
+
+  std::vector<uint64_t> m_counts;
+};
@@ -0,0 +1,106 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+///
+/// Sender-side combining of reductions.  Updates to the same key are merged
+/// locally and only the merged value leaves the rank, which saves messages
+/// when a few keys receive most of the updates.
+///
+
+/// Direct-mapped cache of pending reductions.  An update to a key already in
+/// its slot is merged in place; any other key evicts the slot, sending its
+/// pending value with send(key, value).  flush() must be called before the
+/// barrier that completes the reductions.
+template <typename Key, typename Value, typename SendFunction>
+class local_combiner {
+ public:
+  /// Capacity is rounded up to a power of two
+  local_combiner(const uint64_t capacity, SendFunction send)
+      : m_slots(std::bit_ceil(std::max<uint64_t>(capacity, 1))),
+        m_shift(64 - std::countr_zero(m_slots.size())),
+        m_send(send) {}
+
+  local_combiner(const local_combiner &) = delete;
+  local_combiner &operator=(const local_combiner &) = delete;
+
+  void async_reduce(const Key &key, const Value &value) {
+    slot &s = m_slots[slot_index(key)];
+
+    if (s.occupied && s.key == key) {
+      s.value += value;
+      ++m_hits;
+      return;
+    }
+
+    if (s.occupied) {
+      send(s);
+    }
+    s.key      = key;
+    s.value    = value;
+    s.occupied = true;
+    ++m_misses;
+  }
+
+  /// Sends all pending values
+  void flush() {
+    for (auto &s : m_slots) {
+      if (s.occupied) {
+        send(s);
+        s.occupied = false;
+      }
+    }
+  }
+
+  uint64_t capacity() const { return m_slots.size(); }
+
+  /// Updates merged into a pending value
+  uint64_t hits() const { return m_hits; }
+
+  /// Updates that started a new pending value
+  uint64_t misses() const { return m_misses; }
+
+  /// Merged values sent so far
+  uint64_t sent() const { return m_sent; }
+
+ private:
+  struct slot {
+    Key   key{};
+    Value value{};
+    bool  occupied{false};
+  };
+
+  // Fibonacci hashing, so runs of consecutive keys spread across slots
+  uint64_t slot_index(const Key &key) const {
+    if (m_slots.size() == 1) {
+      return 0;
+    }
+    return (uint64_t(key) * 0x9e3779b97f4a7c15ULL) >> m_shift;
+  }
+
+  void send(const slot &s) {
+    m_send(s.key, s.value);
+    ++m_sent;
+  }
+
+  std::vector<slot> m_slots;
+  int               m_shift;
+  SendFunction      m_send;
+  uint64_t          m_hits{0};
+  uint64_t          m_misses{0};
+  uint64_t          m_sent{0};
+};
+
+template <typename Key, typename Value, typename SendFunction>
+local_combiner<Key, Value, SendFunction> make_local_combiner(
+    const uint64_t capacity, SendFunction send) {
+  return local_combiner<Key, Value, SendFunction>(capacity, send);
+}
@@ -0,0 +1,199 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include <boost/json/src.hpp>
+
+///
+/// Per-phase memory profiling.  Each rank's resident set, peak resident set
+/// and anonymous huge pages are recorded at named phases of a benchmark, and
+/// their distribution across ranks is added to the JSON output.
+///
+
+/// Reads a field such as "VmRSS" from a /proc file of "Field: N kB" lines, in
+/// KB.  Returns 0 if the file or field is missing.
+uint64_t read_proc_kb(const std::string &path, const std::string &field) {
+  std::ifstream file(path);
+  std::string   line;
+  uint64_t      value = 0;
+
+  while (std::getline(file, line)) {
+    if (line.find(field + ":") == 0) {
+      value = std::stoull(line.substr(field.size() + 1));
+    }
+  }
+
+  return value;
+}
+
+/// Reads a field such as "VmRSS" or "VmHWM" from /proc/self/status, in KB
+uint64_t read_proc_status_kb(const std::string &field) {
+  return read_proc_kb("/proc/self/status", field);
+}
+
+/// Resets VmHWM to the current VmRSS so peaks can be measured per phase.
+/// Silently does nothing on kernels without /proc/self/clear_refs support.
+void reset_peak_rss() {
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  clear_refs << "5";
+}
+
+/// Memory counters of this process, in KB
+struct memory_counters {
+  uint64_t rss_kb;        // VmRSS
+  uint64_t hwm_kb;        // VmHWM, the peak since the last reset
+  uint64_t anon_huge_kb;  // AnonHugePages
+};
+
+memory_counters read_memory_counters() {
+  return {read_proc_status_kb("VmRSS"), read_proc_status_kb("VmHWM"),
+          read_proc_kb("/proc/self/smaps_rollup", "AnonHugePages")};
+}
+
+/// Background thread polling the resident set, which catches peaks inside a
+/// timed region even where VmHWM cannot be reset.  Reads /proc/self/statm,
+/// which is cheaper to parse than /proc/self/status.
+class rss_sampler {
+ public:
+  explicit rss_sampler(const std::chrono::milliseconds interval)
+      : m_interval(interval) {}
+
+  rss_sampler(const rss_sampler &) = delete;
+  rss_sampler &operator=(const rss_sampler &) = delete;
+
+  ~rss_sampler() { stop(); }
+
+  void start() {
+    stop();
+    m_peak_kb = current_rss_kb();
+    m_running = true;
+    m_thread  = std::thread([this] { run(); });
+  }
+
+  /// Stops sampling and returns the largest resident set seen, in KB
+  uint64_t stop() {
+    if (m_thread.joinable()) {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+      }
+      m_wake.notify_one();
+      m_thread.join();
+      m_peak_kb = std::max(m_peak_kb, current_rss_kb());
+    }
+    return m_peak_kb;
+  }
+
+  bool running() const { return m_thread.joinable(); }
+
+ private:
+  static uint64_t current_rss_kb() {
+    std::ifstream statm("/proc/self/statm");
+    uint64_t      size_pages{0};
+    uint64_t      resident_pages{0};
+    statm >> size_pages >> resident_pages;
+    return resident_pages * (sysconf(_SC_PAGESIZE) / 1024);
+  }
+
+  void run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_wake.wait_for(lock, m_interval, [this] { return !m_running; })) {
+      m_peak_kb = std::max(m_peak_kb, current_rss_kb());
+    }
+  }
+
+  std::chrono::milliseconds m_interval;
+  std::thread               m_thread;
+  std::mutex                m_mutex;
+  std::condition_variable   m_wake;
+  bool                      m_running{false};
+  uint64_t                  m_peak_kb{0};
+};
+
+/// Records memory counters at named phases into output["MEMORY"].  Each
+/// phase holds one entry per record() call, with the MIN, MAX and SUM of
+/// every counter across ranks and its IMBALANCE, the max over the mean.
+class memory_profile {
+ public:
+  static constexpr int s_sample_interval_ms = 10;
+
+  memory_profile(MPI_Comm comm, boost::json::object &output)
+      : m_comm(comm),
+        m_output(output),
+        m_sampler(std::chrono::milliseconds(s_sample_interval_ms)) {
+    boost::json::object memory;
+    memory["SAMPLE_INTERVAL_MS"] = s_sample_interval_ms;
+    m_output["MEMORY"]           = std::move(memory);
+  }
+
+  /// Starts the background sampler, so the next record() reports the peak
+  /// reached in between
+  void start_sampling() { m_sampler.start(); }
+
+  /// Collectively appends the current counters to phase.  VM_HWM_KB is the
+  /// peak since the last reset_peak_rss().  Stops the sampler if it is running
+  /// and adds the peak it saw as SAMPLED_PEAK_RSS_KB.
+  void record(const std::string &phase) {
+    memory_counters counters = read_memory_counters();
+    bool            sampled  = m_sampler.running();
+
+    // The sampled peak is last, so it can be left out when not sampling
+    constexpr int num_values = 4;
+    const char   *names[num_values] = {"VM_RSS_KB", "VM_HWM_KB",
+                                       "ANON_HUGE_PAGES_KB",
+                                       "SAMPLED_PEAK_RSS_KB"};
+    uint64_t      values[num_values] = {counters.rss_kb, counters.hwm_kb,
+                                        counters.anon_huge_kb,
+                                        sampled ? m_sampler.stop() : 0};
+    int           num_reported = sampled ? num_values : num_values - 1;
+
+    uint64_t mins[num_values];
+    uint64_t maxs[num_values];
+    uint64_t sums[num_values];
+    MPI_Allreduce(values, mins, num_values, MPI_UINT64_T, MPI_MIN, m_comm);
+    MPI_Allreduce(values, maxs, num_values, MPI_UINT64_T, MPI_MAX, m_comm);
+    MPI_Allreduce(values, sums, num_values, MPI_UINT64_T, MPI_SUM, m_comm);
+
+    int size;
+    MPI_Comm_size(m_comm, &size);
+
+    boost::json::object entry;
+    for (int i = 0; i < num_reported; ++i) {
+      double mean = double(sums[i]) / size;
+
+      boost::json::object stats;
+      stats["MIN"]       = mins[i];
+      stats["MAX"]       = maxs[i];
+      stats["SUM"]       = sums[i];
+      stats["IMBALANCE"] = mean > 0 ? maxs[i] / mean : 0.0;
+      entry[names[i]]    = std::move(stats);
+    }
+
+    auto &memory = m_output["MEMORY"].as_object();
+    if (!memory.contains(phase)) {
+      memory[phase] = boost::json::array();
+    }
+    memory[phase].as_array().emplace_back(std::move(entry));
+  }
+
+ private:
+  MPI_Comm             m_comm;
+  boost::json::object &m_output;
+  rss_sampler          m_sampler;
+};
@@ -0,0 +1,51 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <ygm/detail/ygm_cereal_archive.hpp>
+
+///
+/// Padding added to benchmark messages to sweep message sizes.  Every
+/// message carries the same number of bytes, which are serialized from and
+/// received into one shared buffer, so a payload costs its bytes on the wire
+/// and in YGM's buffers without a per-message allocation.
+///
+
+class message_payload {
+ public:
+  /// Sets the bytes carried by every message, which must match on all ranks
+  static void set_size(const uint64_t bytes) {
+    buffer().resize(bytes);
+    for (uint64_t i = 0; i < bytes; ++i) {
+      buffer()[i] = char(i);
+    }
+  }
+
+  static uint64_t size() { return buffer().size(); }
+
+  // Received payloads overwrite the shared buffer with bytes that are never
+  // read
+  template <typename Archive>
+  static void serialize_bytes(Archive &ar) {
+    if (!buffer().empty()) {
+      ar(cereal::binary_data(buffer().data(), buffer().size()));
+    }
+  }
+
+  template <typename Archive>
+  void serialize(Archive &ar) {
+    serialize_bytes(ar);
+  }
+
+ private:
+  static std::vector<char> &buffer() {
+    static std::vector<char> s_buffer;
+    return s_buffer;
+  }
+};
@@ -4,9 +4,16 @@
 // SPDX-License-Identifier: MIT
 
 #pragma once
+#include <counter_random_stream.hpp>
 #include <ygm/comm.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <random>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
 
 #include <assert.h>
 #include <stdint.h>
@@ -91,11 +98,161 @@ inline uint64_t hash_nbits(uint64_t input, int n) {
   return input;
 }
 
+///
+/// Bijective scrambling
+///
+
+inline uint64_t feistel_round(uint64_t half, uint64_t key) {
+  half = (half ^ key) * 0x9e3779b97f4a7c15;
+  return half ^ (half >> 29);
+}
+
+inline constexpr uint64_t s_feistel_keys[4] = {
+    0x243f6a8885a308d3, 0x13198a2e03707344, 0xa4093822299f31d0,
+    0x082efa98ec4e6c89};
+
+/// Permutes the n-bit integers [0, 2^n) for any 1 <= n <= 64 using a
+/// four-round unbalanced Feistel network over the upper ceil(n/2) and lower
+/// floor(n/2) bits.  Each round xors one half with a function of the other, so
+/// the network is invertible for any n and, since the domain is a power of
+/// two, never needs cycle-walking.  The cost does not depend on n.
+inline uint64_t feistel_nbits(uint64_t input, int n) {
+  const int      low_bits  = n / 2;
+  const uint64_t low_mask  = (uint64_t(1) << low_bits) - 1;
+  const uint64_t high_mask = (uint64_t(-1) >> (64 - n)) >> low_bits;
+
+  uint64_t high = (input >> low_bits) & high_mask;
+  uint64_t low  = input & low_mask;
+  low ^= feistel_round(high, s_feistel_keys[0]) & low_mask;
+  high ^= feistel_round(low, s_feistel_keys[1]) & high_mask;
+  low ^= feistel_round(high, s_feistel_keys[2]) & low_mask;
+  high ^= feistel_round(low, s_feistel_keys[3]) & high_mask;
+
+  return (high << low_bits) | low;
+}
+
+/// Inverse of feistel_nbits()
+inline uint64_t feistel_nbits_inverse(uint64_t input, int n) {
+  const int      low_bits  = n / 2;
+  const uint64_t low_mask  = (uint64_t(1) << low_bits) - 1;
+  const uint64_t high_mask = (uint64_t(-1) >> (64 - n)) >> low_bits;
+
+  uint64_t high = (input >> low_bits) & high_mask;
+  uint64_t low  = input & low_mask;
+  high ^= feistel_round(low, s_feistel_keys[3]) & high_mask;
+  low ^= feistel_round(high, s_feistel_keys[2]) & low_mask;
+  high ^= feistel_round(low, s_feistel_keys[1]) & high_mask;
+  low ^= feistel_round(high, s_feistel_keys[0]) & low_mask;
+
+  return (high << low_bits) | low;
+}
+
+/// Function used to scramble vertex IDs of RMAT generators.
+///
+/// hash: hash_nbits(), whose cost grows with the vertex scale and which
+/// requires a scale above 16.
+/// feistel: feistel_nbits(), a fixed-cost bijection for any scale.
+enum class rmat_scrambler { hash, feistel };
+
+/// Source of randomness used by rmat_edge_generator.
+///
+/// sequential: a single std::mt19937 stream; edge i depends on every edge
+/// generated before it.
+/// counter: edge i is a pure function of (seed, i), allowing random access
+/// to any range of edges.
+enum class rmat_rng { sequential, counter };
+
+/// RMAT options that benchmarks expose on the command line
+struct rmat_parameters {
+  double         a{0.57};
+  double         b{0.19};
+  double         c{0.19};
+  double         d{0.05};
+  bool           scramble{true};
+  rmat_scrambler scrambler{rmat_scrambler::hash};
+  bool           undirected{false};
+};
+
+/// Parses "a,b,c,d" into the quadrant probabilities of params.  Returns false
+/// unless there are four non-negative values summing to 1.
+inline bool parse_rmat_probabilities(const std::string &str,
+                                     rmat_parameters   &params) {
+  std::stringstream ss(str);
+  double            probabilities[4];
+  char              separator;
+  for (int i = 0; i < 4; ++i) {
+    if (!(ss >> probabilities[i]) || probabilities[i] < 0.0 ||
+        (i < 3 && !(ss >> separator && separator == ','))) {
+      return false;
+    }
+  }
+
+  double total = probabilities[0] + probabilities[1] + probabilities[2] +
+                 probabilities[3];
+  if (!(ss >> std::ws).eof() || std::abs(total - 1.0) > 1e-6) {
+    return false;
+  }
+
+  params.a = probabilities[0];
+  params.b = probabilities[1];
+  params.c = probabilities[2];
+  params.d = probabilities[3];
+
+  return true;
+}
+
+/// Parses "none", "hash" or "feistel" into the scrambling options of params
+inline bool parse_rmat_scrambler(const std::string &str,
+                                 rmat_parameters   &params) {
+  if (str == "none") {
+    params.scramble = false;
+  } else if (str == "hash") {
+    params.scramble  = true;
+    params.scrambler = rmat_scrambler::hash;
+  } else if (str == "feistel") {
+    params.scramble  = true;
+    params.scrambler = rmat_scrambler::feistel;
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
+/// Name of the scrambler selected by params as reported in JSON output
+inline std::string rmat_scrambler_name(const rmat_parameters &params) {
+  if (!params.scramble) {
+    return "NONE";
+  } else if (params.scrambler == rmat_scrambler::feistel) {
+    return "FEISTEL";
+  }
+  return "HASH";
+}
+
+/// Identifies params for use in cache keys
+inline std::string rmat_parameters_key(const rmat_parameters &params) {
+  std::stringstream ss;
+  ss << "a" << params.a << "_b" << params.b << "_c" << params.c << "_d"
+     << params.d;
+  if (params.scramble) {
+    ss << (params.scrambler == rmat_scrambler::feistel ? "_feistel"
+                                                       : "_scrambled");
+  }
+  if (params.undirected) {
+    ss << "_undirected";
+  }
+
+  return ss.str();
+}
+
 /// RMAT edge generator, based on Boost Graph's RMAT generator
 ///
 /// Options include scrambling vertices based on a hash funciton, and
 /// symmetrizing the list.   Generated edges are not sorted.  May contain
 /// duplicate and self edges.
+///
+/// With rmat_rng::counter, edges can also be generated out of order through
+/// generate_edge_at() and generate_range().
 class rmat_edge_generator {
  public:
   typedef uint64_t                      vertex_descriptor;
@@ -106,7 +263,9 @@ class rmat_edge_generator {
   rmat_edge_generator(uint64_t vertex_scale, uint64_t edge_count,
                       uint64_t seed = 1234, bool scramble = true,
                       bool undirected = false, double a = 0.57, double b = 0.19,
-                      double c = 0.19, double d = 0.05)
+                      double c = 0.19, double d = 0.05,
+                      rmat_rng rng = rmat_rng::sequential,
+                      rmat_scrambler scrambler = rmat_scrambler::hash)
       : m_seed(seed),
         m_gen(seed),
         m_distribution(0.0, 1.0),
@@ -117,7 +276,10 @@ class rmat_edge_generator {
         m_rmat_a(a),
         m_rmat_b(b),
         m_rmat_c(c),
-        m_rmat_d(d) {}
+        m_rmat_d(d),
+        m_rng(rng),
+        m_scrambler(scrambler),
+        m_next_edge(0) {}
 
   uint64_t max_vertex_id() {
     return (uint64_t(1) << uint64_t(m_vertex_scale)) - 1;
@@ -125,8 +287,15 @@ class rmat_edge_generator {
 
   size_t size() { return m_edge_count; }
 
+  bool is_counter_based() const { return m_rng == rmat_rng::counter; }
+
   template <typename Function>
   void for_all(Function fn) {
+    if (is_counter_based()) {
+      generate_range(0, m_edge_count, fn);
+      return;
+    }
+
     m_gen.seed(m_seed);
     for (uint64_t i = 0; i < m_edge_count; ++i) {
       const auto [src, dest] = generate_edge();
@@ -138,12 +307,101 @@ class rmat_edge_generator {
     }
   }
 
-  edge_type generate_single_edge() { return generate_edge(); }
+  /// Calls fn on edges [begin, end).  Requires rmat_rng::counter.  Edges are
+  /// identical to the ones for_all() produces for the same indices.
+  template <typename Function>
+  void generate_range(uint64_t begin, uint64_t end, Function fn) const {
+    assert(is_counter_based());
+    edge_type batch[s_batch_lanes];
+    for (uint64_t i = begin; i < end; i += s_batch_lanes) {
+      const size_t count = std::min<uint64_t>(s_batch_lanes, end - i);
+      generate_batch(i, std::span<edge_type>(batch, count));
+
+      for (size_t j = 0; j < count; ++j) {
+        const auto [src, dest] = batch[j];
+        fn(src, dest);
+
+        if (m_undirected) {
+          fn(dest, src);
+        }
+      }
+    }
+  }
+
+  /// Fills edges with the next edges.size() edges, continuing from previous
+  /// calls to generate_batch() and generate_single_edge().  Produces the same
+  /// edges as calling generate_single_edge() repeatedly, but generates
+  /// several edges at a time.  Reversed edges of undirected generators are
+  /// not produced.
+  void generate_batch(std::span<edge_type> edges) {
+    if (is_counter_based()) {
+      generate_batch(m_next_edge, edges);
+      m_next_edge += edges.size();
+      return;
+    }
+
+    // The sequential stream cannot be split, so draw each edge's values from
+    // it in order and hand them to the lanes afterwards.
+    const size_t        draws_per_edge = 5 * m_vertex_scale;
+    std::vector<double> draws(s_batch_lanes * draws_per_edge, 0.0);
+    for (size_t i = 0; i < edges.size(); i += s_batch_lanes) {
+      const size_t count = std::min(s_batch_lanes, edges.size() - i);
+      for (size_t k = 0; k < count * draws_per_edge; ++k) {
+        draws[k] = m_distribution(m_gen);
+      }
+
+      generate_lanes(
+          [&draws, draws_per_edge](const size_t lane, const size_t draw) {
+            return draws[lane * draws_per_edge + draw];
+          },
+          edges.data() + i, count);
+    }
+  }
+
+  /// Fills edges with edges [first_edge, first_edge + edges.size()).
+  /// Requires rmat_rng::counter.
+  void generate_batch(uint64_t first_edge, std::span<edge_type> edges) const {
+    assert(is_counter_based());
+    counter_random_stream streams[s_batch_lanes];
+    for (size_t i = 0; i < edges.size(); i += s_batch_lanes) {
+      const size_t count = std::min(s_batch_lanes, edges.size() - i);
+      for (size_t lane = 0; lane < s_batch_lanes; ++lane) {
+        streams[lane] = counter_random_stream(m_seed, first_edge + i + lane);
+      }
+
+      generate_lanes(
+          [&streams](const size_t lane, const size_t) {
+            return streams[lane].next_double();
+          },
+          edges.data() + i, count);
+    }
+  }
+
+  /// Returns edge i without generating any of the edges before it.  Requires
+  /// rmat_rng::counter.  Does not produce the reversed edge of undirected
+  /// generators.
+  edge_type generate_edge_at(uint64_t i) const {
+    assert(is_counter_based());
+    counter_random_stream stream(m_seed, i);
+    return generate_edge([&stream]() { return stream.next_double(); });
+  }
+
+  edge_type generate_single_edge() {
+    if (is_counter_based()) {
+      return generate_edge_at(m_next_edge++);
+    }
+    return generate_edge();
+  }
 
  protected:
-  /// Generates a new RMAT edge.  This function was adapted from the Boost Graph
-  /// Library.
   edge_type generate_edge() {
+    return generate_edge([this]() { return m_distribution(m_gen); });
+  }
+
+  /// Generates a new RMAT edge using uniform() as the source of random values
+  /// in [0, 1).  This function was adapted from the Boost Graph Library.
+  template <typename UniformFunction>
+  edge_type generate_edge(UniformFunction &&uniform) const {
     double   rmat_a = m_rmat_a;
     double   rmat_b = m_rmat_b;
     double   rmat_c = m_rmat_c;
@@ -151,7 +409,7 @@ class rmat_edge_generator {
     uint64_t u = 0, v = 0;
     uint64_t step = (uint64_t(1) << m_vertex_scale) / 2;
     for (unsigned int j = 0; j < m_vertex_scale; ++j) {
-      double p = m_distribution(m_gen);
+      double p = uniform();
 
       if (p < rmat_a)
         ;
@@ -168,10 +426,10 @@ class rmat_edge_generator {
 
       // 0.2 and 0.9 are hardcoded in the reference SSCA implementation.
       // The maximum change in any given value should be less than 10%
-      rmat_a *= 0.9 + 0.2 * m_distribution(m_gen);
-      rmat_b *= 0.9 + 0.2 * m_distribution(m_gen);
-      rmat_c *= 0.9 + 0.2 * m_distribution(m_gen);
-      rmat_d *= 0.9 + 0.2 * m_distribution(m_gen);
+      rmat_a *= 0.9 + 0.2 * uniform();
+      rmat_b *= 0.9 + 0.2 * uniform();
+      rmat_c *= 0.9 + 0.2 * uniform();
+      rmat_d *= 0.9 + 0.2 * uniform();
 
       double S = rmat_a + rmat_b + rmat_c + rmat_d;
 
@@ -183,13 +441,100 @@ class rmat_edge_generator {
       rmat_d = 1. - rmat_a - rmat_b - rmat_c;
     }
     if (m_scramble) {
-      u = hash_nbits(u, m_vertex_scale);
-      v = hash_nbits(v, m_vertex_scale);
+      u = scramble_vertex(u);
+      v = scramble_vertex(v);
     }
 
     return std::make_pair(u, v);
   }
 
+  vertex_descriptor scramble_vertex(vertex_descriptor v) const {
+    if (m_scrambler == rmat_scrambler::feistel) {
+      return feistel_nbits(v, m_vertex_scale);
+    }
+    return hash_nbits(v, m_vertex_scale);
+  }
+
+  /// Number of edges generate_lanes() works on at once
+  static constexpr size_t s_batch_lanes = 16;
+
+  /// Generates count <= s_batch_lanes RMAT edges into out.  Performs the same
+  /// arithmetic as generate_edge(), but keeps one RMAT state per lane and
+  /// selects quadrants without branches so the loops over lanes vectorize.
+  /// uniform(lane, draw) returns the draw-th random value of a lane's edge;
+  /// every lane draws its values in the same order generate_edge() does.
+  template <typename LaneUniform>
+  void generate_lanes(LaneUniform &&uniform, edge_type *out,
+                      const size_t count) const {
+    constexpr size_t L = s_batch_lanes;
+    double           rmat_a[L], rmat_b[L], rmat_c[L], rmat_d[L];
+    double           p[L];
+    uint64_t         u[L], v[L];
+
+    for (size_t l = 0; l < L; ++l) {
+      rmat_a[l] = m_rmat_a;
+      rmat_b[l] = m_rmat_b;
+      rmat_c[l] = m_rmat_c;
+      rmat_d[l] = m_rmat_d;
+      u[l]      = 0;
+      v[l]      = 0;
+    }
+
+    uint64_t step = (uint64_t(1) << m_vertex_scale) / 2;
+    size_t   draw = 0;
+    for (unsigned int j = 0; j < m_vertex_scale; ++j) {
+      for (size_t l = 0; l < L; ++l) {
+        p[l] = uniform(l, draw);
+      }
+      ++draw;
+
+      for (size_t l = 0; l < L; ++l) {
+        const double ab   = rmat_a[l] + rmat_b[l];
+        const double abc  = ab + rmat_c[l];
+        const bool   in_b = p[l] >= rmat_a[l] && p[l] < ab;
+        const bool   in_d = p[l] >= abc;
+        u[l] += step * uint64_t(p[l] >= ab);
+        v[l] += step * uint64_t(in_b | in_d);
+      }
+
+      step /= 2;
+
+      for (size_t l = 0; l < L; ++l) {
+        rmat_a[l] *= 0.9 + 0.2 * uniform(l, draw);
+      }
+      ++draw;
+      for (size_t l = 0; l < L; ++l) {
+        rmat_b[l] *= 0.9 + 0.2 * uniform(l, draw);
+      }
+      ++draw;
+      for (size_t l = 0; l < L; ++l) {
+        rmat_c[l] *= 0.9 + 0.2 * uniform(l, draw);
+      }
+      ++draw;
+      for (size_t l = 0; l < L; ++l) {
+        rmat_d[l] *= 0.9 + 0.2 * uniform(l, draw);
+      }
+      ++draw;
+
+      for (size_t l = 0; l < L; ++l) {
+        double S = rmat_a[l] + rmat_b[l] + rmat_c[l] + rmat_d[l];
+
+        rmat_a[l] /= S;
+        rmat_b[l] /= S;
+        rmat_c[l] /= S;
+        rmat_d[l] = 1. - rmat_a[l] - rmat_b[l] - rmat_c[l];
+      }
+    }
+
+    for (size_t l = 0; l < count; ++l) {
+      if (m_scramble) {
+        u[l] = scramble_vertex(u[l]);
+        v[l] = scramble_vertex(v[l]);
+      }
+      out[l] = std::make_pair(u[l], v[l]);
+    }
+  }
+
   const uint64_t                         m_seed;
   std::mt19937                           m_gen;
   std::uniform_real_distribution<double> m_distribution;
@@ -201,9 +546,18 @@ class rmat_edge_generator {
   const double                           m_rmat_b;
   const double                           m_rmat_c;
   const double                           m_rmat_d;
+  const rmat_rng                         m_rng;
+  const rmat_scrambler                   m_scrambler;
+  uint64_t                               m_next_edge;
 };
 
 // RMAT generator that splits edge generation responsibilities across ranks
+//
+// With rmat_rng::sequential, each rank runs its own stream seeded by its rank,
+// so the global graph changes with the number of ranks.  With
+// rmat_rng::counter, each rank generates a contiguous slice of the global edge
+// indices from a single global seed, so the global edge multiset is identical
+// for any number of ranks.
 class distributed_rmat_edge_generator {
  public:
   distributed_rmat_edge_generator(ygm::comm &world, uint64_t vertex_scale,
@@ -211,19 +565,73 @@ class distributed_rmat_edge_generator {
                                   uint64_t seed = 1234, bool scramble = true,
                                   bool undirected = false, double a = 0.57,
                                   double b = 0.19, double c = 0.19,
-                                  double d = 0.05)
+                                  double d = 0.05,
+                                  rmat_rng rng = rmat_rng::sequential,
+                                  rmat_scrambler scrambler =
+                                      rmat_scrambler::hash)
       : m_local_generator(
             vertex_scale,
-            global_edge_count / world.size() +
-                (world.rank() < (global_edge_count % world.size())),
-            seed * world.size() + world.rank(), scramble, undirected, a, b, c,
-            d) {}
+            rng == rmat_rng::counter
+                ? global_edge_count
+                : local_edge_count(world, global_edge_count),
+            rng == rmat_rng::counter ? seed
+                                     : seed * world.size() + world.rank(),
+            scramble, undirected, a, b, c, d, rng, scrambler),
+        m_edge_begin(local_edge_offset(world, global_edge_count)),
+        m_edge_end(m_edge_begin + local_edge_count(world, global_edge_count)),
+        m_next_edge(0) {}
 
   template <typename Function>
   void for_all(Function fn) {
-    m_local_generator.for_all(fn);
+    if (m_local_generator.is_counter_based()) {
+      m_local_generator.generate_range(m_edge_begin, m_edge_end, fn);
+    } else {
+      m_local_generator.for_all(fn);
+    }
+  }
+
+  /// Fills edges with the next edges.size() edges of this rank, continuing
+  /// from previous calls.  Produces the same edges as for_all(), without the
+  /// reversed edges of undirected generators.
+  void generate_batch(std::span<rmat_edge_generator::edge_type> edges) {
+    assert(m_next_edge + edges.size() <= local_size());
+    if (m_local_generator.is_counter_based()) {
+      m_local_generator.generate_batch(m_edge_begin + m_next_edge, edges);
+    } else {
+      m_local_generator.generate_batch(edges);
+    }
+    m_next_edge += edges.size();
+  }
+
+  /// Fills edges with this rank's edges [first_edge, first_edge +
+  /// edges.size()), independently of other calls.  Requires rmat_rng::counter.
+  void generate_batch(uint64_t                                  first_edge,
+                      std::span<rmat_edge_generator::edge_type> edges) const {
+    assert(first_edge + edges.size() <= local_size());
+    m_local_generator.generate_batch(m_edge_begin + first_edge, edges);
   }
 
+  bool is_counter_based() const { return m_local_generator.is_counter_based(); }
+
+  /// Number of edges generated by this rank, not counting reversed edges of
+  /// undirected generators
+  uint64_t local_size() const { return m_edge_end - m_edge_begin; }
+
  private:
+  static uint64_t local_edge_count(ygm::comm &world,
+                                   uint64_t   global_edge_count) {
+    return global_edge_count / world.size() +
+           (uint64_t(world.rank()) < (global_edge_count % world.size()));
+  }
+
+  static uint64_t local_edge_offset(ygm::comm &world,
+                                    uint64_t   global_edge_count) {
+    return world.rank() * (global_edge_count / world.size()) +
+           std::min<uint64_t>(world.rank(), global_edge_count % world.size());
+  }
+
   rmat_edge_generator m_local_generator;
+  uint64_t            m_edge_begin;
+  uint64_t            m_edge_end;
+  uint64_t            m_next_edge;
 };
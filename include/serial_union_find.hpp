@@ -0,0 +1,76 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+///
+/// Serial union-find over arbitrary 64-bit vertex ids, used on a single rank
+/// to check and to pre-contract distributed connected components.  Vertices
+/// are added on first use and mapped to dense indices.
+///
+
+class serial_union_find {
+ public:
+  /// Merges the sets of a and b.  Returns false if they were already one set.
+  bool unite(const uint64_t a, const uint64_t b) {
+    uint64_t root_a = find_index(index_of(a));
+    uint64_t root_b = find_index(index_of(b));
+    if (root_a == root_b) {
+      return false;
+    }
+
+    // Union by size keeps trees shallow
+    if (m_size[root_a] < m_size[root_b]) {
+      std::swap(root_a, root_b);
+    }
+    m_parent[root_b] = root_a;
+    m_size[root_a] += m_size[root_b];
+    ++m_num_unions;
+
+    return true;
+  }
+
+  /// Representative vertex of v's set
+  uint64_t find(const uint64_t v) {
+    return m_vertices[find_index(index_of(v))];
+  }
+
+  bool contains(const uint64_t v) const { return m_index.count(v) > 0; }
+
+  uint64_t num_vertices() const { return m_vertices.size(); }
+
+  uint64_t num_sets() const { return m_vertices.size() - m_num_unions; }
+
+ private:
+  uint64_t index_of(const uint64_t v) {
+    auto [itr, inserted] = m_index.try_emplace(v, m_vertices.size());
+    if (inserted) {
+      m_vertices.push_back(v);
+      m_parent.push_back(itr->second);
+      m_size.push_back(1);
+    }
+    return itr->second;
+  }
+
+  // Path halving
+  uint64_t find_index(uint64_t i) {
+    while (m_parent[i] != i) {
+      m_parent[i] = m_parent[m_parent[i]];
+      i           = m_parent[i];
+    }
+    return i;
+  }
+
+  std::unordered_map<uint64_t, uint64_t> m_index;
+  std::vector<uint64_t>                  m_vertices;
+  std::vector<uint64_t>                  m_parent;
+  std::vector<uint64_t>                  m_size;
+  uint64_t                               m_num_unions{0};
+};
@@ -0,0 +1,501 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+#include <counter_random_stream.hpp>
+#include <rmat_edge_generator.hpp>
+#include <ygm/comm.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <span>
+#include <string>
+
+#include <assert.h>
+#include <stdint.h>
+
+///
+/// Synthetic workloads with controllable skew and locality
+///
+
+/// Graphs produced by synthetic_edge_generator.
+///
+/// erdos_renyi: G(n, m) with both endpoints uniform.
+/// zipf: both endpoints Zipf-distributed with a tunable exponent, so a few
+/// hot vertices receive most updates.
+/// chung_lu: expected vertex degrees follow a power law with exponent gamma.
+/// Endpoints are drawn proportionally to the expected degrees, which is a Zipf
+/// distribution with exponent 1 / (gamma - 1).
+/// grid_2d, grid_3d, torus_2d, torus_3d: lattices over row-major vertex IDs,
+/// so neighbors have nearby IDs and a block-partitioned container (such as
+/// ygm::container::array) usually owns both on the same rank.  Hash-partitioned
+/// containers do not preserve this.
+/// block_local: each endpoint is owned by the rank generating the edge with
+/// probability local_fraction, and by another rank otherwise.  Ownership
+/// follows a block partition, as in ygm::container::array, or with
+/// cyclic_blocks a cyclic one, vertex v on rank v % ranks.  Hash-partitioned
+/// containers do not preserve it.
+enum class synthetic_graph {
+  erdos_renyi,
+  zipf,
+  chung_lu,
+  grid_2d,
+  grid_3d,
+  torus_2d,
+  torus_3d,
+  block_local
+};
+
+/// Tuning knobs of synthetic graphs.  Each only affects the graphs named.
+struct synthetic_graph_options {
+  double zipf_exponent{1.0};       // zipf
+  double power_law_exponent{2.5};  // chung_lu
+  double local_fraction{0.9};      // block_local
+  bool   cyclic_blocks{false};     // block_local
+  bool   scramble{true};           // zipf, chung_lu
+};
+
+/// Parses the command-line name of a synthetic graph.  Returns false for
+/// unknown names.
+inline bool parse_synthetic_graph(const std::string &name,
+                                  synthetic_graph   &graph) {
+  if (name == "er" || name == "erdos_renyi") {
+    graph = synthetic_graph::erdos_renyi;
+  } else if (name == "zipf") {
+    graph = synthetic_graph::zipf;
+  } else if (name == "chung_lu") {
+    graph = synthetic_graph::chung_lu;
+  } else if (name == "grid2d") {
+    graph = synthetic_graph::grid_2d;
+  } else if (name == "grid3d") {
+    graph = synthetic_graph::grid_3d;
+  } else if (name == "torus2d") {
+    graph = synthetic_graph::torus_2d;
+  } else if (name == "torus3d") {
+    graph = synthetic_graph::torus_3d;
+  } else if (name == "block_local") {
+    graph = synthetic_graph::block_local;
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
+/// Name of a synthetic graph as reported in JSON output
+inline std::string synthetic_graph_name(const synthetic_graph graph) {
+  switch (graph) {
+    case synthetic_graph::erdos_renyi:
+      return "ERDOS_RENYI";
+    case synthetic_graph::zipf:
+      return "ZIPF";
+    case synthetic_graph::chung_lu:
+      return "CHUNG_LU";
+    case synthetic_graph::grid_2d:
+      return "GRID_2D";
+    case synthetic_graph::grid_3d:
+      return "GRID_3D";
+    case synthetic_graph::torus_2d:
+      return "TORUS_2D";
+    case synthetic_graph::torus_3d:
+      return "TORUS_3D";
+    case synthetic_graph::block_local:
+      return "BLOCK_LOCAL";
+  }
+
+  return "UNKNOWN";
+}
+
+/// Uniform integer in [0, bound) from a 64-bit random value
+inline uint64_t scale_random(const uint64_t random, const uint64_t bound) {
+  return (unsigned __int128)random * bound >> 64;
+}
+
+/// Zipf distribution over [0, n), where value k has probability proportional
+/// to 1 / (k + 1)^exponent.  Uses the rejection-inversion method of Hormann
+/// and Derflinger, which needs constant time and memory for any n and accepts
+/// more than 90% of candidates.
+class zipf_distribution {
+ public:
+  zipf_distribution(uint64_t n, double exponent)
+      : m_n(n),
+        m_exponent(exponent),
+        m_h_integral_x1(h_integral(1.5) - 1.0),
+        m_h_integral_n(h_integral(n + 0.5)),
+        m_s(2.0 - h_integral_inverse(h_integral(2.5) - h(2.0))) {}
+
+  /// Draws a value using uniform() as the source of values in [0, 1)
+  template <typename UniformFunction>
+  uint64_t operator()(UniformFunction &&uniform) const {
+    while (true) {
+      double u =
+          m_h_integral_n + uniform() * (m_h_integral_x1 - m_h_integral_n);
+      double   x = h_integral_inverse(u);
+      uint64_t k = std::clamp<double>(x + 0.5, 1.0, m_n);
+      if (k - x <= m_s || u >= h_integral(k + 0.5) - h(k)) {
+        return k - 1;
+      }
+    }
+  }
+
+ private:
+  double h(double x) const { return std::exp(-m_exponent * std::log(x)); }
+
+  double h_integral(double x) const {
+    double log_x = std::log(x);
+    return helper2((1.0 - m_exponent) * log_x) * log_x;
+  }
+
+  double h_integral_inverse(double x) const {
+    double t = std::max(x * (1.0 - m_exponent), -1.0);
+    return std::exp(helper1(t) * x);
+  }
+
+  // log(1 + x) / x, accurate near 0
+  static double helper1(double x) {
+    if (std::abs(x) > 1e-8) {
+      return std::log1p(x) / x;
+    }
+    return 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+  }
+
+  // (exp(x) - 1) / x, accurate near 0
+  static double helper2(double x) {
+    if (std::abs(x) > 1e-8) {
+      return std::expm1(x) / x;
+    }
+    return 1.0 + x * 0.5 * (1.0 + x * (1.0 / 3.0) * (1.0 + 0.25 * x));
+  }
+
+  uint64_t m_n;
+  double   m_exponent;
+  double   m_h_integral_x1;
+  double   m_h_integral_n;
+  double   m_s;
+};
+
+/// Generator for the graphs of synthetic_graph over 2^vertex_scale vertices.
+///
+/// Edge i is a pure function of (seed, i) for every graph, so edges can be
+/// generated out of order and from several threads, and the global graph is
+/// the same for any number of ranks.  The exception is block_local, whose
+/// edges depend on num_blocks, the number of ranks sharing the edges.
+///
+/// Lattices have a fixed number of edges, lattice_edge_count().  When more
+/// edges are requested, edge i of a lattice repeats edge i modulo that count.
+/// Other graphs may contain duplicate and self edges.
+class synthetic_edge_generator {
+ public:
+  typedef uint64_t                      vertex_descriptor;
+  typedef std::pair<uint64_t, uint64_t> value_type;
+  typedef value_type                    edge_type;
+
+  synthetic_edge_generator(synthetic_graph graph, uint64_t vertex_scale,
+                           uint64_t edge_count, uint64_t seed = 1234,
+                           uint64_t num_blocks = 1,
+                           const synthetic_graph_options &options = {})
+      : m_graph(graph),
+        m_vertex_scale(vertex_scale),
+        m_num_vertices(uint64_t(1) << vertex_scale),
+        m_edge_count(edge_count),
+        m_seed(seed),
+        m_num_blocks(num_blocks),
+        m_options(options),
+        m_zipf(m_num_vertices, graph == synthetic_graph::chung_lu
+                                   ? 1.0 / (options.power_law_exponent - 1.0)
+                                   : options.zipf_exponent),
+        m_lattice_edges(lattice_edge_count(graph, vertex_scale)) {
+    assert(graph != synthetic_graph::chung_lu ||
+           options.power_law_exponent > 1.0);
+    assert(options.local_fraction >= 0.0 && options.local_fraction <= 1.0);
+    assert(lattice_dimensions(graph) == 0 || m_lattice_edges > 0);
+
+    int dimensions = lattice_dimensions(graph);
+    for (int k = 0; k < dimensions; ++k) {
+      m_side[k]   = lattice_side(vertex_scale, dimensions, k);
+      m_stride[k] = k == 0 ? 1 : m_stride[k - 1] * m_side[k - 1];
+    }
+  }
+
+  uint64_t max_vertex_id() const { return m_num_vertices - 1; }
+
+  size_t size() const { return m_edge_count; }
+
+  /// Number of distinct edges in a lattice, or 0 for other graphs
+  static uint64_t lattice_edge_count(synthetic_graph graph,
+                                     uint64_t        vertex_scale) {
+    int      dimensions   = lattice_dimensions(graph);
+    uint64_t num_vertices = uint64_t(1) << vertex_scale;
+    bool     torus        = graph == synthetic_graph::torus_2d ||
+                 graph == synthetic_graph::torus_3d;
+
+    uint64_t count{0};
+    for (int k = 0; k < dimensions; ++k) {
+      uint64_t side = lattice_side(vertex_scale, dimensions, k);
+      count += torus ? num_vertices : num_vertices / side * (side - 1);
+    }
+
+    return count;
+  }
+
+  template <typename Function>
+  void for_all(Function fn) const {
+    generate_range(0, m_edge_count, fn);
+  }
+
+  /// Calls fn on edges [begin, end)
+  template <typename Function>
+  void generate_range(uint64_t begin, uint64_t end, Function fn) const {
+    for (uint64_t i = begin; i < end; ++i) {
+      const auto [src, dest] = generate_edge_at(i);
+      fn(src, dest);
+    }
+  }
+
+  /// Fills edges with edges [first_edge, first_edge + edges.size())
+  void generate_batch(uint64_t first_edge, std::span<edge_type> edges) const {
+    for (size_t i = 0; i < edges.size(); ++i) {
+      edges[i] = generate_edge_at(first_edge + i);
+    }
+  }
+
+  /// Returns edge i without generating any of the edges before it
+  edge_type generate_edge_at(uint64_t i) const {
+    counter_random_stream stream(m_seed, i);
+
+    switch (m_graph) {
+      case synthetic_graph::erdos_renyi: {
+        uint64_t u = scale_random(stream.next(), m_num_vertices);
+        uint64_t v = scale_random(stream.next(), m_num_vertices);
+        return edge_type(u, v);
+      }
+      case synthetic_graph::zipf:
+      case synthetic_graph::chung_lu: {
+        auto     uniform = [&stream]() { return stream.next_double(); };
+        uint64_t u       = scramble_vertex(m_zipf(uniform));
+        uint64_t v       = scramble_vertex(m_zipf(uniform));
+        return edge_type(u, v);
+      }
+      case synthetic_graph::grid_2d:
+      case synthetic_graph::grid_3d:
+      case synthetic_graph::torus_2d:
+      case synthetic_graph::torus_3d:
+        return lattice_edge(i % m_lattice_edges);
+      case synthetic_graph::block_local: {
+        uint64_t block = edge_block(i);
+        uint64_t u     = block_local_vertex(stream, block);
+        uint64_t v     = block_local_vertex(stream, block);
+        return edge_type(u, v);
+      }
+    }
+
+    return edge_type(0, 0);
+  }
+
+ private:
+  static int lattice_dimensions(synthetic_graph graph) {
+    switch (graph) {
+      case synthetic_graph::grid_2d:
+      case synthetic_graph::torus_2d:
+        return 2;
+      case synthetic_graph::grid_3d:
+      case synthetic_graph::torus_3d:
+        return 3;
+      default:
+        return 0;
+    }
+  }
+
+  /// Length of dimension k of a lattice.  Lower dimensions get any bits of
+  /// the vertex scale that do not divide evenly.
+  static uint64_t lattice_side(uint64_t vertex_scale, int dimensions, int k) {
+    uint64_t bits = vertex_scale / dimensions +
+                    (uint64_t(k) < vertex_scale % dimensions);
+    return uint64_t(1) << bits;
+  }
+
+  uint64_t scramble_vertex(uint64_t v) const {
+    if (m_options.scramble && m_vertex_scale > 0) {
+      return feistel_nbits(v, m_vertex_scale);
+    }
+    return v;
+  }
+
+  /// Edge i of a lattice.  Edges are numbered by dimension, then by the
+  /// lower-numbered endpoint.
+  edge_type lattice_edge(uint64_t i) const {
+    bool torus = m_graph == synthetic_graph::torus_2d ||
+                 m_graph == synthetic_graph::torus_3d;
+
+    for (int k = 0;; ++k) {
+      uint64_t side   = m_side[k];
+      uint64_t stride = m_stride[k];
+
+      if (torus) {
+        if (i < m_num_vertices) {
+          uint64_t coord = (i / stride) % side;
+          return edge_type(i, i - coord * stride + (coord + 1) % side * stride);
+        }
+        i -= m_num_vertices;
+      } else {
+        uint64_t count = m_num_vertices / side * (side - 1);
+        if (i < count) {
+          uint64_t inner = i % stride;
+          uint64_t coord = (i / stride) % (side - 1);
+          uint64_t outer = i / stride / (side - 1);
+          uint64_t u     = outer * side * stride + coord * stride + inner;
+          return edge_type(u, u + stride);
+        }
+        i -= count;
+      }
+    }
+  }
+
+  /// Block generating edge i when the edges are split evenly among
+  /// m_num_blocks ranks
+  uint64_t edge_block(uint64_t i) const {
+    uint64_t min_size   = m_edge_count / m_num_blocks;
+    uint64_t num_larger = m_edge_count % m_num_blocks;
+    if (i < num_larger * (min_size + 1)) {
+      return i / (min_size + 1);
+    }
+    return num_larger + (i - num_larger * (min_size + 1)) / min_size;
+  }
+
+  /// Vertex owned by block with probability local_fraction, and uniform over
+  /// the vertices owned by other blocks otherwise.  Blocks match the
+  /// partitioning of ygm::container::array, or with cyclic_blocks assign
+  /// vertex v to block v % m_num_blocks.
+  uint64_t block_local_vertex(counter_random_stream &stream,
+                              uint64_t               block) const {
+    if (m_options.cyclic_blocks) {
+      return cyclic_local_vertex(stream, block);
+    }
+
+    uint64_t block_size =
+        (m_num_vertices + m_num_blocks - 1) / m_num_blocks;
+    uint64_t begin = std::min(block * block_size, m_num_vertices);
+    uint64_t size  = std::min(block_size, m_num_vertices - begin);
+
+    bool local = stream.next_double() < m_options.local_fraction;
+    if (size == m_num_vertices || (local && size > 0)) {
+      return begin + scale_random(stream.next(), size);
+    }
+
+    uint64_t v = scale_random(stream.next(), m_num_vertices - size);
+    return v < begin ? v : v + size;
+  }
+
+  uint64_t cyclic_local_vertex(counter_random_stream &stream,
+                               uint64_t               block) const {
+    uint64_t size = block < m_num_vertices
+                        ? (m_num_vertices - block + m_num_blocks - 1) /
+                              m_num_blocks
+                        : 0;
+
+    bool local = stream.next_double() < m_options.local_fraction;
+    if (size == m_num_vertices || (local && size > 0)) {
+      return block + m_num_blocks * scale_random(stream.next(), size);
+    }
+
+    // The k-th vertex of other blocks, skipping block in each round
+    uint64_t k     = scale_random(stream.next(), m_num_vertices - size);
+    uint64_t round = k / (m_num_blocks - 1);
+    uint64_t other = k % (m_num_blocks - 1);
+    return round * m_num_blocks + (other < block ? other : other + 1);
+  }
+
+  synthetic_graph         m_graph;
+  uint64_t                m_vertex_scale;
+  uint64_t                m_num_vertices;
+  uint64_t                m_edge_count;
+  uint64_t                m_seed;
+  uint64_t                m_num_blocks;
+  synthetic_graph_options m_options;
+  zipf_distribution       m_zipf;
+  uint64_t                m_lattice_edges;
+  uint64_t                m_side[3]{1, 1, 1};
+  uint64_t                m_stride[3]{1, 1, 1};
+};
+
+/// Splits the edges of a synthetic_edge_generator among the ranks of world.
+/// Each rank generates a contiguous slice of the global edge indices, as
+/// distributed_rmat_edge_generator does with rmat_rng::counter.
+class distributed_synthetic_edge_generator {
+ public:
+  distributed_synthetic_edge_generator(
+      ygm::comm &world, synthetic_graph graph, uint64_t vertex_scale,
+      uint64_t global_edge_count, uint64_t seed = 1234,
+      const synthetic_graph_options &options = {})
+      : m_local_generator(graph, vertex_scale, global_edge_count, seed,
+                          world.size(), options),
+        m_edge_begin(world.rank() * (global_edge_count / world.size()) +
+                     std::min<uint64_t>(world.rank(),
+                                        global_edge_count % world.size())),
+        m_edge_end(m_edge_begin + global_edge_count / world.size() +
+                   (uint64_t(world.rank()) <
+                    (global_edge_count % world.size()))),
+        m_next_edge(0) {}
+
+  template <typename Function>
+  void for_all(Function fn) const {
+    m_local_generator.generate_range(m_edge_begin, m_edge_end, fn);
+  }
+
+  /// Fills edges with the next edges.size() edges of this rank, continuing
+  /// from previous calls
+  void generate_batch(std::span<synthetic_edge_generator::edge_type> edges) {
+    assert(m_next_edge + edges.size() <= local_size());
+    m_local_generator.generate_batch(m_edge_begin + m_next_edge, edges);
+    m_next_edge += edges.size();
+  }
+
+  /// Fills edges with this rank's edges [first_edge, first_edge +
+  /// edges.size()), independently of other calls
+  void generate_batch(
+      uint64_t                                       first_edge,
+      std::span<synthetic_edge_generator::edge_type> edges) const {
+    assert(first_edge + edges.size() <= local_size());
+    m_local_generator.generate_batch(m_edge_begin + first_edge, edges);
+  }
+
+  /// Always true.  Matches distributed_rmat_edge_generator so kernels can
+  /// treat both the same way.
+  bool is_counter_based() const { return true; }
+
+  uint64_t local_size() const { return m_edge_end - m_edge_begin; }
+
+ private:
+  synthetic_edge_generator m_local_generator;
+  uint64_t                 m_edge_begin;
+  uint64_t                 m_edge_end;
+  uint64_t                 m_next_edge;
+};
+
+/// Identifies a synthetic graph and the options that affect it, for use in
+/// cache keys
+inline std::string synthetic_graph_key(const synthetic_graph          graph,
+                                       const synthetic_graph_options &options) {
+  std::string key = synthetic_graph_name(graph);
+  std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+
+  if (graph == synthetic_graph::zipf) {
+    key += "_z" + std::to_string(options.zipf_exponent);
+  } else if (graph == synthetic_graph::chung_lu) {
+    key += "_gamma" + std::to_string(options.power_law_exponent);
+  } else if (graph == synthetic_graph::block_local) {
+    key += "_local" + std::to_string(options.local_fraction);
+    if (options.cyclic_blocks) {
+      key += "_cyclic";
+    }
+  }
+  if ((graph == synthetic_graph::zipf || graph == synthetic_graph::chung_lu) &&
+      options.scramble) {
+    key += "_scrambled";
+  }
+
+  return key;
+}
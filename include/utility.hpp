@@ -4,11 +4,17 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include <algorithm>
 #include <fstream>
+#include <span>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <boost/json/src.hpp>
 
+#include <ygm/collective.hpp>
 #include <ygm/comm.hpp>
 #include <ygm/io/detail/csv.hpp>
 
@@ -75,6 +81,30 @@ void parse_stats(ygm::comm &c, boost::json::object &o) {
   }
 }
 
+/// Value of the integer statistic label as printed by ygm::comm::stats_print(),
+/// or 0 if it is not reported
+int64_t read_stat(ygm::comm &c, const std::string &label) {
+  std::stringstream ss;
+
+  c.stats_print("", ss);
+
+  std::string line;
+  while (std::getline(ss, line)) {
+    auto space_pos = line.find(" ");
+    auto equal_pos = line.find("=");
+
+    if (equal_pos != 0 && equal_pos != std::string::npos &&
+        line.substr(0, space_pos) == label) {
+      ygm::io::detail::csv_field field(line.substr(equal_pos + 2));
+      if (field.is_integer()) {
+        return field.as_integer();
+      }
+    }
+  }
+
+  return 0;
+}
+
 void print_indents(std::ostream &os, std::string indent, int indent_count) {
   for (int i = 0; i < indent_count; ++i) {
     os << indent;
@@ -152,3 +182,97 @@ std::vector<std::vector<T>> gather_vectors_rank_0(
 
   return to_return;
 }
+
+/// Splits [0, count) into num_threads contiguous blocks and calls
+/// fn(begin, end) on each block from its own thread.  The calling thread
+/// handles the first block.
+template <typename Function>
+void parallel_for_blocks(const int num_threads, const uint64_t count,
+                         Function fn) {
+  auto block_begin = [num_threads, count](const uint64_t thread) {
+    return thread * (count / num_threads) +
+           std::min<uint64_t>(thread, count % num_threads);
+  };
+
+  std::vector<std::thread> threads;
+  for (int t = 1; t < num_threads; ++t) {
+    threads.emplace_back(fn, block_begin(t), block_begin(t + 1));
+  }
+
+  fn(block_begin(0), block_begin(1));
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+/// Collects the items for_all(fn) passes to fn into batches of batch_size and
+/// calls process(batch) on each, the last batch possibly short.  With
+/// collective set, every rank makes the same number of calls, padding with
+/// empty batches, so process may call collectives.  Returns the number of
+/// nonempty batches.
+template <typename T, typename ForAll, typename Process>
+uint64_t for_all_batches(ygm::comm &world, const uint64_t batch_size,
+                         const bool collective, ForAll for_all,
+                         Process process) {
+  std::vector<T> batch;
+  batch.reserve(batch_size);
+  uint64_t num_batches{0};
+
+  // Returns true once every rank has processed its last batch
+  auto end_batch = [&](const bool last) {
+    num_batches += !batch.empty();
+    process(std::span<const T>(batch));
+    batch.clear();
+    return collective ? ygm::logical_and(last, world) : last;
+  };
+
+  for_all([&batch, batch_size, &end_batch](const T &item) {
+    batch.push_back(item);
+    if (batch.size() == batch_size) {
+      end_batch(false);
+    }
+  });
+
+  if (collective) {
+    while (!end_batch(true)) {
+    }
+  } else if (!batch.empty()) {
+    end_batch(true);
+  }
+
+  return num_batches;
+}
+
+/// Rank that owns key in a YGM container, i.e. the rank an update to key is
+/// sent to
+template <typename Container, typename Key>
+int container_owner(const Container &cont, const Key &key) {
+  return cont.partitioner.owner(key);
+}
+
+/// Given the number of updates this rank sent to each rank, returns the
+/// largest number of updates received by any rank and the mean over all ranks
+std::pair<uint64_t, double> receive_load(
+    ygm::comm &world, const std::vector<uint64_t> &sent_to_rank) {
+  uint64_t received{0};
+  auto     received_ptr = world.make_ygm_ptr(received);
+
+  world.barrier();
+
+  for (int rank = 0; rank < world.size(); ++rank) {
+    if (sent_to_rank[rank] > 0) {
+      world.async(
+          rank,
+          [](const uint64_t count, auto received_ptr) {
+            *received_ptr += count;
+          },
+          sent_to_rank[rank], received_ptr);
+    }
+  }
+
+  world.barrier();
+
+  return std::make_pair(ygm::max(received, world),
+                        double(ygm::sum(received, world)) / world.size());
+}
@@ -61,6 +61,17 @@ def parse_commands():
     parser.add_argument("-p", "--pretty-print", action="store_true", help="Pretty-print all JSON output")
     parser.add_argument("-t", "--num-trials", help="Number of trials to run of each experiment")
     parser.add_argument("-o", "--output", help="File for output (writes to stdout if unspecified)")
+    parser.add_argument("--generation-threads", help="Number of threads each rank uses to generate inputs in histo, \
+            agups and connected components experiments")
+    parser.add_argument("--rank-invariant-inputs", action="store_true", help="Generate RMAT inputs that are identical for \
+            any number of ranks (needed for strong scaling)")
+    parser.add_argument("--input-cache-dir", help="Directory where histo and connected components experiments cache \
+            generated inputs for reuse by later trials and runs")
+    parser.add_argument("--stream-inputs", action="store_true", help="Generate histo and connected components inputs \
+            on the fly while sending instead of materializing them before the timed region")
+    parser.add_argument("--batch-size", nargs="*", help="Number of inputs per rank generated and sent as one batch \
+            in histo and connected components experiments (bounds peak memory)")
+    parser.add_argument("--batch-barrier", action="store_true", help="Barrier after each batch of --batch-size")
 
     # Experiment arguments
     parser.add_argument("--no-atw-ygm", action="store_true", help="Skip around-the-world ygm experiment")
@@ -68,18 +79,39 @@ def parse_commands():
     parser.add_argument("--no-histo-rmat", action="store_true", help="Skip histogram test with RMAT inputs")
     parser.add_argument("--no-histo-rmat-reducing-adapter", action="store_true", help="Skip histogram test with \
             RMAT inputs using reducing adapter")
+    parser.add_argument("--no-histo-rmat-bulk", action="store_true", help="Skip bulk-synchronous histogram test with \
+            RMAT inputs")
     parser.add_argument("--no-histo-uniform", action="store_true", help="Skip histogram test with uniformly generated inputs")
     parser.add_argument("--no-agups", action="store_true", help="Skip agups experiment")
+    parser.add_argument("--no-agups-hpcc", action="store_true", help="Skip agups experiment in HPCC RandomAccess mode")
     parser.add_argument("--no-cc-rmat", action="store_true", help="Skip connected components RMAT experiment")
     parser.add_argument("--no-cc-linked-list", action="store_true", help="Skip connected components linked-list experiment")
     parser.add_argument("--no-embed-ygm", action="store_true", help="Skip krowkee experiment embedding graph vertices")
 
     parser.add_argument("-n", "--num-trips", nargs="*", help="Number of trips around the world in around-the-world experiments")
     parser.add_argument("--no-wait-until", action="store_true", help="Do not test ygm::comm::wait_until() in around-the-world")
+    parser.add_argument("--payload-bytes", nargs="*", help="Bytes of payload added to each message in around-the-world \
+            ygm and agups experiments (e.g. 0 64 1024 16384 65536)")
     parser.add_argument("-s", "--table-scale", nargs="*", help="log_2 of table size for use in histo and agups experiments")
     parser.add_argument("-i", "--histo-inserts-per-rank", nargs="*", help="Number of insertions spawned by each rank in histo experiments")
+    parser.add_argument("--histo-total-inserts", nargs="*", help="Number of insertions split across all ranks in histo \
+            experiments (overrides --histo-inserts-per-rank; required by --rank-invariant-inputs)")
+    parser.add_argument("--histo-container", nargs="*", help="Containers backing histo experiments (array, map, \
+            counting_set)")
+    parser.add_argument("--hot-keys", nargs="*", help="Number of hot indices replicated on every rank in histo \
+            RMAT and synthetic experiments")
+    parser.add_argument("--word-bits", nargs="*", help="Bits per index and value sent in histo and agups \
+            experiments (32 or 64)")
+    parser.add_argument("--combiner-capacity", nargs="*", help="Local combiner cache entries for histo experiments \
+            with the reducing adapter")
     parser.add_argument("-u", "--agups-updaters-per-rank", nargs="*", help="Number of updaters spawned by each rank in agups experiments")
     parser.add_argument("-l", "--agups-updater-lifetime", nargs="*", help="Number of jumps made by each updater in agups experiments")
+    parser.add_argument("--agups-hop-modes", action="store_true", help="Also run agups with local hops inline (-L), \
+            batched visits (-B) and both")
+    parser.add_argument("--agups-latency", action="store_true", help="Also run agups recording latency percentiles \
+            (-P), so its overhead can be measured against the uninstrumented runs")
+    parser.add_argument("--agups-hpcc-bucket-size", nargs="*", help="Updates per destination rank sent as one message \
+            in agups HPCC RandomAccess experiments")
     parser.add_argument("-g", "--cc-graph-scale", nargs="*", help="Logarithmic graph scale for connected components \
             experiments (overridden by --cc-rmat-graph-scale and --cc-linked-list-graph-scale)")
     parser.add_argument("--cc-rmat-graph-scale", nargs="*", help="Logarithmic graph scale for connected components \
@@ -87,6 +119,27 @@ def parse_commands():
     parser.add_argument("--cc-linked-list-graph-scale", nargs="*", help="Logarithmic graph scale for connected components \
             linked list experiments")
     parser.add_argument("--cc-edgefactor", nargs="*", help="Edgefactor for connected components RMAT experiments")
+    parser.add_argument("--cc-algorithms", nargs="*", help="Connected components algorithms to sweep (dset, fastsv, \
+            labelprop)")
+    parser.add_argument("--cc-precontract", action="store_true", help="Also run connected components experiments with \
+            local union-find pre-contraction (-c)")
+    parser.add_argument("--cc-queries", nargs="*", help="Same-component queries per rank after each batch of \
+            connected components experiments (requires --batch-size)")
+    parser.add_argument("--cc-verify", action="store_true", help="Verify the component counts of connected components \
+            experiments (gathers every edge to rank 0 except for linked lists, so only for small scales)")
+    parser.add_argument("--rmat-params", nargs="*", help="RMAT quadrant probabilities a,b,c,d to sweep in histo, \
+            connected components and krowkee RMAT experiments")
+    parser.add_argument("--rmat-scrambler", nargs="*", help="RMAT vertex scramblers to sweep (none, hash, feistel)")
+    parser.add_argument("--rmat-undirected", action="store_true", help="Generate undirected RMAT graphs")
+    parser.add_argument("--synthetic-graphs", nargs="*", help="Synthetic generators to run histo and connected \
+            components experiments with (er, zipf, chung_lu, grid2d, grid3d, torus2d, torus3d, block_local)")
+    parser.add_argument("--zipf-exponent", nargs="*", help="Zipf exponents for zipf synthetic experiments")
+    parser.add_argument("--power-law-exponent", nargs="*", help="Degree exponents for chung_lu synthetic experiments")
+    parser.add_argument("--local-fraction", nargs="*", help="Fractions of rank-local endpoints for block_local \
+            synthetic experiments")
+    parser.add_argument("--cc-edge-list", nargs="*", help="Edge list files or directories to run connected components \
+            on (runs the cc_file experiment)")
+    parser.add_argument("--cc-edge-list-format", help="Format of files given to --cc-edge-list (text or binary)")
     parser.add_argument("-d", "--embedding-dimension", nargs="*", help="Number of embedding dimensions for krowkee \
             experiments")
     parser.add_argument("-v", "--krowkee-log-vertex-count", nargs="*", help="log_2 of number of vertices for krowkee \
@@ -138,6 +191,18 @@ def parse_commands():
             exp_commands["histo_rmat_ra"].add_arg("-s", args.table_scale)
         if args.histo_inserts_per_rank:
             exp_commands["histo_rmat_ra"].add_arg("-i", args.histo_inserts_per_rank)
+        if args.combiner_capacity:
+            exp_commands["histo_rmat_ra"].add_arg("-K", args.combiner_capacity)
+
+    # HISTO_RMAT bulk-synchronous arguments
+    if (not args.no_histo_rmat_bulk):
+        exp_commands["histo_rmat_bulk"] = command_parameter_generator('../build/src/histo_ygm')
+        exp_commands["histo_rmat_bulk"].add_required_flag("-r")
+        exp_commands["histo_rmat_bulk"].add_required_flag("-B")
+        if args.table_scale:
+            exp_commands["histo_rmat_bulk"].add_arg("-s", args.table_scale)
+        if args.histo_inserts_per_rank:
+            exp_commands["histo_rmat_bulk"].add_arg("-i", args.histo_inserts_per_rank)
 
     # AGUPS arguments
     if (not args.no_agups):
@@ -148,6 +213,19 @@ def parse_commands():
             exp_commands["agups"].add_arg("-u", args.agups_updaters_per_rank)
         if args.agups_updater_lifetime:
             exp_commands["agups"].add_arg("-l", args.agups_updater_lifetime)
+        if args.agups_hop_modes:
+            exp_commands["agups"].add_flag("-L")
+            exp_commands["agups"].add_flag("-B")
+        if args.agups_latency:
+            exp_commands["agups"].add_flag("-P")
+
+    if (not args.no_agups_hpcc):
+        exp_commands["agups_hpcc"] = command_parameter_generator("../build/src/agups_ygm")
+        exp_commands["agups_hpcc"].add_required_flag("-H")
+        if args.table_scale:
+            exp_commands["agups_hpcc"].add_arg("-s", args.table_scale)
+        if args.agups_hpcc_bucket_size:
+            exp_commands["agups_hpcc"].add_arg("-k", args.agups_hpcc_bucket_size)
 
     # CC_RMAT arguments
     if (not args.no_cc_rmat):
@@ -168,6 +246,36 @@ def parse_commands():
         elif args.cc_graph_scale:
             exp_commands["cc_linked_list"].add_arg("-g", args.cc_graph_scale)
 
+    # HISTO_SYNTHETIC and CC_SYNTHETIC arguments
+    if args.synthetic_graphs:
+        exp_commands["histo_synthetic"] = command_parameter_generator('../build/src/histo_ygm')
+        if args.table_scale:
+            exp_commands["histo_synthetic"].add_arg("-s", args.table_scale)
+        if args.histo_inserts_per_rank:
+            exp_commands["histo_synthetic"].add_arg("-i", args.histo_inserts_per_rank)
+
+        exp_commands["cc_synthetic"] = command_parameter_generator("../build/src/cc_ygm")
+        if args.cc_graph_scale:
+            exp_commands["cc_synthetic"].add_arg("-g", args.cc_graph_scale)
+        if args.cc_edgefactor:
+            exp_commands["cc_synthetic"].add_arg("-e", args.cc_edgefactor)
+
+        for exp_name in ["histo_synthetic", "cc_synthetic"]:
+            exp_commands[exp_name].add_arg("-d", args.synthetic_graphs)
+            if args.zipf_exponent:
+                exp_commands[exp_name].add_arg("-z", args.zipf_exponent)
+            if args.power_law_exponent:
+                exp_commands[exp_name].add_arg("-G", args.power_law_exponent)
+            if args.local_fraction:
+                exp_commands[exp_name].add_arg("-L", args.local_fraction)
+
+    # CC_FILE arguments
+    if args.cc_edge_list:
+        exp_commands["cc_file"] = command_parameter_generator("../build/src/cc_ygm")
+        exp_commands["cc_file"].add_arg("-f", args.cc_edge_list)
+        if args.cc_edge_list_format:
+            exp_commands["cc_file"].add_required_arg("-F", args.cc_edge_list_format)
+
     # EMBED_YGM
     if (not args.no_embed_ygm):
         exp_commands["embed_ygm"] = command_parameter_generator("../build/src/embed_ygm")
@@ -182,6 +290,82 @@ def parse_commands():
             exp_commands["embed_ygm"].add_arg("-s", args.krowkee_seed)
 
     # Shared arguments
+    if args.generation_threads:
+        for exp_name in ["histo_uniform", "histo_rmat", "histo_rmat_ra", "histo_rmat_bulk", "histo_synthetic", "agups",
+                "cc_rmat", "cc_linked_list", "cc_synthetic"]:
+            if exp_name in exp_commands:
+                exp_commands[exp_name].add_required_arg("-T", args.generation_threads)
+    if args.histo_total_inserts:
+        for exp_name in ["histo_uniform", "histo_rmat", "histo_rmat_ra", "histo_rmat_bulk", "histo_synthetic"]:
+            if exp_name in exp_commands:
+                exp_commands[exp_name].add_arg("-N", args.histo_total_inserts)
+    if args.rank_invariant_inputs:
+        # Per-rank insertion counts grow with the number of ranks, so identical histo inputs need a total count
+        if not args.histo_total_inserts and any(exp_name in exp_commands for exp_name in ["histo_uniform",
+                "histo_rmat", "histo_rmat_ra", "histo_rmat_bulk"]):
+            parser.error("--rank-invariant-inputs requires --histo-total-inserts for histo experiments")
+        for exp_name in ["histo_uniform", "histo_rmat", "histo_rmat_ra", "histo_rmat_bulk", "cc_rmat"]:
+            if exp_name in exp_commands:
+                exp_commands[exp_name].add_required_flag("-I")
+    if args.rmat_params or args.rmat_scrambler or args.rmat_undirected:
+        for exp_name in ["histo_rmat", "histo_rmat_ra", "histo_rmat_bulk", "cc_rmat", "embed_ygm"]:
+            if exp_name in exp_commands:
+                if args.rmat_params:
+                    exp_commands[exp_name].add_arg("-R", args.rmat_params)
+                if args.rmat_scrambler:
+                    exp_commands[exp_name].add_arg("-S", args.rmat_scrambler)
+                if args.rmat_undirected:
+                    exp_commands[exp_name].add_required_flag("-U")
+    if args.hot_keys:
+        for exp_name in ["histo_rmat", "histo_synthetic"]:
+            if exp_name in exp_commands:
+                exp_commands[exp_name].add_arg("-H", args.hot_keys)
+    if args.histo_container:
+        for exp_name in ["histo_uniform", "histo_rmat", "histo_synthetic"]:
+            if exp_name in exp_commands:
+                exp_commands[exp_name].add_arg("-c", args.histo_container)
+    if args.word_bits:
+        for exp_name in ["histo_uniform", "histo_rmat", "histo_rmat_ra", "histo_rmat_bulk", "histo_synthetic",
+                "agups"]:
+            if exp_name in exp_commands:
+                exp_commands[exp_name].add_arg("-W", args.word_bits)
+    if args.payload_bytes:
+        for exp_name in ["atw_ygm", "agups"]:
+            if exp_name in exp_commands:
+                exp_commands[exp_name].add_arg("-b", args.payload_bytes)
+    if args.input_cache_dir:
+        for exp_name in ["histo_uniform", "histo_rmat", "histo_rmat_ra", "histo_rmat_bulk", "histo_synthetic",
+                "cc_rmat", "cc_linked_list", "cc_synthetic"]:
+            if exp_name in exp_commands:
+                exp_commands[exp_name].add_required_arg("-C", args.input_cache_dir)
+    if args.stream_inputs:
+        for exp_name in ["histo_uniform", "histo_rmat", "histo_rmat_ra", "histo_synthetic", "cc_rmat",
+                "cc_linked_list", "cc_synthetic", "cc_file"]:
+            if exp_name in exp_commands:
+                exp_commands[exp_name].add_required_flag("-m")
+    if args.batch_size:
+        for exp_name in ["histo_uniform", "histo_rmat", "histo_rmat_ra", "histo_rmat_bulk", "histo_synthetic",
+                "cc_rmat", "cc_linked_list", "cc_synthetic", "cc_file"]:
+            if exp_name in exp_commands:
+                exp_commands[exp_name].add_arg("-b", args.batch_size)
+                if args.batch_barrier:
+                    exp_commands[exp_name].add_required_flag("-q")
+    if args.cc_algorithms:
+        for exp_name in ["cc_rmat", "cc_linked_list", "cc_synthetic", "cc_file"]:
+            if exp_name in exp_commands:
+                exp_commands[exp_name].add_arg("-a", args.cc_algorithms)
+    if args.cc_precontract:
+        for exp_name in ["cc_rmat", "cc_linked_list", "cc_synthetic", "cc_file"]:
+            if exp_name in exp_commands:
+                exp_commands[exp_name].add_flag("-c")
+    if args.cc_queries:
+        for exp_name in ["cc_rmat", "cc_linked_list", "cc_synthetic", "cc_file"]:
+            if exp_name in exp_commands:
+                exp_commands[exp_name].add_arg("-Q", args.cc_queries)
+    if args.cc_verify:
+        for exp_name in ["cc_rmat", "cc_linked_list", "cc_synthetic", "cc_file"]:
+            if exp_name in exp_commands:
+                exp_commands[exp_name].add_required_flag("-V")
     if args.num_trials:
         for exp_name, command in exp_commands.items():
             exp_commands[exp_name].add_required_arg("-t", args.num_trials)
@@ -17,9 +17,13 @@ def parse_arguments():
     parser.add_argument("-o", "--output-dir", help="Output directory")
     parser.add_argument("-A", "--account", help="Bank to use with Slurm")
     parser.add_argument("--use-lsf", action="store_true", help="Use LSF scheduler instead of Slurm")
+    parser.add_argument("--strong-scaling", action="store_true", help="Keep problem scales fixed as the number of \
+            nodes grows and generate RMAT inputs that are identical for any number of ranks")
 
     # Experiment arguments
     parser.add_argument("-s", "--table-scale-per-node", type=int, help="log_2 of table size per node for use in histo and agups experiments (default=20)", default=20)
+    parser.add_argument("--histo-total-inserts", type=int, help="Number of insertions across all ranks in histo \
+            experiments with --strong-scaling (default=2^25)", default=(1 << 25))
     parser.add_argument("-g", "--cc-graph-scale-per-node", type=int, help="Logarithmic graph scale per node for connected components \
             experiments (overridden by --cc-rmat-graph-scale-per-node and --cc-linked-list-graph-scale-per-node)", default=20)
     parser.add_argument("--cc-rmat-graph-scale-per-node", type=int, help="Logarithmic graph scale per node for connected components \
@@ -46,17 +50,26 @@ def run_experiments(args, passthrough_args):
         else:
             output_filename = "ygm_bench_N" + str(num_nodes)
 
-        table_scale = args.table_scale_per_node + int(math.log2(num_nodes))
-        cc_rmat_scale = args.cc_graph_scale_per_node + int(math.log2(num_nodes))
-        cc_linked_list_scale = args.cc_graph_scale_per_node + int(math.log2(num_nodes))
+        if args.strong_scaling:
+            scale_increase = 0
+        else:
+            scale_increase = int(math.log2(num_nodes))
+
+        table_scale = args.table_scale_per_node + scale_increase
+        cc_rmat_scale = args.cc_graph_scale_per_node + scale_increase
+        cc_linked_list_scale = args.cc_graph_scale_per_node + scale_increase
         if args.cc_rmat_graph_scale_per_node:
-            cc_rmat_scale = args.cc_rmat_graph_scale_per_node + int(math.log2(num_nodes))
+            cc_rmat_scale = args.cc_rmat_graph_scale_per_node + scale_increase
         if args.cc_linked_list_graph_scale_per_node:
-            cc_linked_list_scale = args.cc_linked_list_graph_scale_per_node + int(math.log2(num_nodes))
-        krowkee_vertex_scale = args.krowkee_vertex_scale_per_node + int(math.log2(num_nodes))
+            cc_linked_list_scale = args.cc_linked_list_graph_scale_per_node + scale_increase
+        krowkee_vertex_scale = args.krowkee_vertex_scale_per_node + scale_increase
 
         run_experiments_options = ""
 
+        if args.strong_scaling:
+            run_experiments_options += " --rank-invariant-inputs"
+            run_experiments_options += " --histo-total-inserts " + str(args.histo_total_inserts)
+
         run_experiments_options += " --table-scale " + str(table_scale) 
         run_experiments_options += " --cc-rmat-graph-scale " + str(cc_rmat_scale)
         run_experiments_options += " --cc-linked-list-graph-scale " + str(cc_linked_list_scale)
@@ -3,6 +3,12 @@
 //
 // SPDX-License-Identifier: MIT
 
+#include <algorithm>
+#include <counter_random_stream.hpp>
+#include <hpcc_random_stream.hpp>
+#include <latency_histogram.hpp>
+#include <memory_profile.hpp>
+#include <message_payload.hpp>
 #include <random>
 #include <utility.hpp>
 #include <ygm/comm.hpp>
@@ -15,6 +21,14 @@ struct parameters_t {
   int64_t local_updaters;
   int     updater_lifetime;
   int     num_trials;
+  int     num_threads;
+  int     word_bits;
+  bool    local_hops;
+  bool    batched_visits;
+  bool    measure_latency;
+  bool    hpcc;
+  int64_t hpcc_bucket_size;
+  int64_t payload_bytes;
   bool    pretty_print;
 
   parameters_t()
@@ -22,6 +36,14 @@ struct parameters_t {
         local_updaters(1024 * 1024),
         updater_lifetime(100),
         num_trials(5),
+        num_threads(1),
+        word_bits(0),
+        local_hops(false),
+        batched_visits(false),
+        measure_latency(false),
+        hpcc(false),
+        hpcc_bucket_size(1024),
+        payload_bytes(0),
         pretty_print(false) {}
 };
 
@@ -31,6 +53,23 @@ void usage(ygm::comm &comm) {
                << "\n\t-u <int>\t- Number of updaters spawned per rank"
                << "\n\t-l <int>\t- Updater lifetime"
                << "\n\t-t <int>\t- Number of trials"
+               << "\n\t-T <int>\t- Number of threads creating updaters per rank"
+               << "\n\t-W <int>\t- Bits of table entries, indices and updater "
+                  "state (32 or 64; default is 32 for tables of fewer than "
+                  "2^32 entries)"
+               << "\n\t-L\t\t- Run hops to locally owned entries inline "
+                  "instead of sending them"
+               << "\n\t-B\t\t- Send all updaters bound for a rank as one "
+                  "batched visit per round"
+               << "\n\t-P\t\t- Record updater lifetime and per-hop latency "
+                  "percentiles (adds 16 bytes to each updater message)"
+               << "\n\t-H\t\t- Run HPCC RandomAccess instead: 4 updates "
+                  "per table entry from the HPCC random sequence, then a "
+                  "verification pass"
+               << "\n\t-k <int>\t- Updates per destination rank sent as "
+                  "one message by -H (default 1024)"
+               << "\n\t-b <int>\t- Bytes of payload added to each updater "
+                  "message (default 0)"
                << "\n\t-p\t\t- Pretty print output"
                << "\n\t-h\t\t- Print help" << std::endl;
 }
@@ -44,7 +83,7 @@ parameters_t parse_cmd_line(int argc, char **argv, ygm::comm &comm) {
   extern int opterr;
   opterr = 0;
 
-  while ((c = getopt(argc, argv, "s:u:l:t:ph")) != -1) {
+  while ((c = getopt(argc, argv, "s:u:l:t:T:W:LBPHk:b:ph")) != -1) {
     switch (c) {
       case 'h':
         prn_help = true;
@@ -61,6 +100,30 @@ parameters_t parse_cmd_line(int argc, char **argv, ygm::comm &comm) {
       case 't':
         params.num_trials = atoi(optarg);
         break;
+      case 'T':
+        params.num_threads = atoi(optarg);
+        break;
+      case 'W':
+        params.word_bits = atoi(optarg);
+        break;
+      case 'L':
+        params.local_hops = true;
+        break;
+      case 'B':
+        params.batched_visits = true;
+        break;
+      case 'P':
+        params.measure_latency = true;
+        break;
+      case 'H':
+        params.hpcc = true;
+        break;
+      case 'k':
+        params.hpcc_bucket_size = atoll(optarg);
+        break;
+      case 'b':
+        params.payload_bytes = atoll(optarg);
+        break;
       case 'p':
         params.pretty_print = true;
         break;
@@ -71,6 +134,45 @@ parameters_t parse_cmd_line(int argc, char **argv, ygm::comm &comm) {
     }
   }
 
+  if (params.word_bits != 0 && params.word_bits != 32 &&
+      params.word_bits != 64) {
+    comm.cerr0() << "Word size (-W) must be 32 or 64" << std::endl;
+    prn_help = true;
+  }
+
+  // A table of 2^32 entries would wrap a 32-bit size to 0
+  if (params.word_bits == 32 && params.log_table_size >= 32) {
+    comm.cerr0() << "32-bit words (-W 32) require fewer than 2^32 table "
+                    "entries"
+                 << std::endl;
+    prn_help = true;
+  }
+
+  if (params.num_threads < 1) {
+    comm.cerr0() << "Number of threads (-T) must be positive" << std::endl;
+    prn_help = true;
+  }
+
+  if (params.hpcc_bucket_size < 1) {
+    comm.cerr0() << "HPCC bucket size (-k) must be positive" << std::endl;
+    prn_help = true;
+  }
+
+  if (params.payload_bytes < 0) {
+    comm.cerr0() << "Payload size (-b) cannot be negative" << std::endl;
+    prn_help = true;
+  }
+
+  if (params.hpcc &&
+      (params.local_hops || params.batched_visits || params.measure_latency ||
+       params.word_bits == 32 || params.payload_bytes > 0)) {
+    comm.cerr0() << "HPCC RandomAccess (-H) sends 64-bit updates without "
+                    "updaters and cannot be combined with -L, -B, -P, -W 32 "
+                    "or -b"
+                 << std::endl;
+    prn_help = true;
+  }
+
   if (prn_help) {
     usage(comm);
     exit(-1);
@@ -81,12 +183,14 @@ parameters_t parse_cmd_line(int argc, char **argv, ygm::comm &comm) {
 
 static parameters_t params;
 
+// Word is the type of the updater's state and of the table entries it visits
+template <typename Word>
 class updater {
  public:
   // Needs default constructor to send through YGM
   updater() {}
 
-  updater(size_t seed) : m_state(seed), m_counter(0) {}
+  updater(Word seed) : m_state(seed), m_counter(0) {}
 
   void increment_counter() const { ++m_counter; }
 
@@ -94,101 +198,483 @@ class updater {
 
   uint32_t get_counter() const { return m_counter; }
 
-  size_t get_state() const { return m_state; }
+  Word get_state() const { return m_state; }
+
+  // Timestamps on rank 0's clock, in nanoseconds, kept with -P
+  int64_t get_spawn_time() const { return m_spawn_time; }
+
+  int64_t get_hop_time() const { return m_hop_time; }
+
+  void start_clock(int64_t now) const {
+    m_spawn_time = now;
+    m_hop_time   = now;
+  }
+
+  void set_hop_time(int64_t now) const { m_hop_time = now; }
 
   template <typename Archive>
   void serialize(Archive &ar) {
-    ar(m_state, m_counter);
+    if (params.measure_latency) {
+      ar(m_state, m_counter, m_spawn_time, m_hop_time);
+    } else {
+      ar(m_state, m_counter);
+    }
+    message_payload::serialize_bytes(ar);
   }
 
-  void update_state(size_t value) const { m_state ^= value; }
+  void update_state(Word value) const { m_state ^= value; }
 
  private:
-  mutable size_t   m_state;
+  mutable Word     m_state;
   mutable uint32_t m_counter;
+  mutable int64_t  m_spawn_time;
+  mutable int64_t  m_hop_time;
 };
 
+// Table of Word entries, indexed by Word
+template <typename Word>
+using agups_table = ygm::container::array<Word, Word>;
+
+// Updaters waiting to be sent to each rank as one batched visit by -B
+template <typename Word>
+using updater_batches = std::vector<std::vector<updater<Word>>>;
+
+// Hops run inline by -L on this rank
+static uint64_t s_local_hops;
+
+// Latencies of the hops and completed updaters visited on this rank with -P
+static int64_t           s_clock_offset_ns;
+static latency_histogram s_hop_latencies;
+static latency_histogram s_lifetime_latencies;
+
+// Time on rank 0's clock with -P
+inline int64_t updater_clock_ns() {
+  return steady_clock_ns() + s_clock_offset_ns;
+}
+
+// Applies one hop of u to the table entry value
+template <typename Word>
+void hop(Word &value, const updater<Word> &u) {
+  u.update_state(value);
+  value = u.get_state();
+  u.increment_counter();
+
+  if (params.measure_latency) {
+    // Clock offsets are estimates, so latencies may come out negative
+    int64_t now = updater_clock_ns();
+    s_hop_latencies.add(std::max<int64_t>(0, now - u.get_hop_time()));
+    u.set_hop_time(now);
+    if (!u.is_alive()) {
+      s_lifetime_latencies.add(std::max<int64_t>(0, now - u.get_spawn_time()));
+    }
+  }
+}
+
+template <typename Word>
+void send_updater(agups_table<Word> &table, const updater<Word> &u,
+                  updater_batches<Word> *batches);
+
+template <typename Word>
 struct recursive_functor {
  public:
   // Creates a copy of u because YGM passes arguments by const reference
-  void operator()(ygm::ygm_ptr<ygm::container::array<size_t>> parray,
-                  const size_t index, size_t &value, updater u) const {
-    u.update_state(value);
-    value = u.get_state();
-    u.increment_counter();
+  void operator()(ygm::ygm_ptr<agups_table<Word>> parray, const Word index,
+                  Word &value, updater<Word> u) const {
+    hop(value, u);
+    send_updater<Word>(*parray, u, nullptr);
+  }
+};
 
-    if (u.is_alive()) {
-      size_t new_index = value & (parray->size() - 1);
-      parray->async_visit(new_index, recursive_functor(), u);
+// Visits every updater of a batch at this rank, which owns their entries
+template <typename Word>
+struct batch_functor {
+ public:
+  void operator()(ygm::ygm_ptr<agups_table<Word>>     parray,
+                  ygm::ygm_ptr<updater_batches<Word>> pbatches,
+                  const std::vector<updater<Word>>   &batch) const {
+    for (const auto &u : batch) {
+      Word index = u.get_state() & (parray->size() - 1);
+      parray->local_visit(index, [&u](const Word i, Word &value) {
+        hop(value, u);
+      });
+      send_updater(*parray, u, &(*pbatches));
     }
   }
 };
 
-int main(int argc, char **argv) {
-  {
-    ygm::comm world(&argc, &argv);
+// Sends u to its next entry if it is alive.  With -L, hops to local entries
+// run inline until u dies or leaves the rank.  With batches, u is queued for
+// the next round instead of sent.
+template <typename Word>
+void send_updater(agups_table<Word> &table, const updater<Word> &u,
+                  updater_batches<Word> *batches) {
+  while (u.is_alive()) {
+    Word index = u.get_state() & (table.size() - 1);
+    int  owner = table.partitioner.owner(index);
+
+    if (params.local_hops && owner == table.comm().rank()) {
+      table.local_visit(index,
+                        [&u](const Word i, Word &value) { hop(value, u); });
+      ++s_local_hops;
+    } else if (batches) {
+      (*batches)[owner].push_back(u);
+      return;
+    } else {
+      table.async_visit(index, recursive_functor<Word>(), u);
+      return;
+    }
+  }
+}
 
-    params = parse_cmd_line(argc, argv, world);
+// Runs all trials with tables, indices and updater state of type Word
+template <typename Word>
+void run_agups(ygm::comm &world, memory_profile &memory,
+               boost::json::object &output) {
+  size_t            global_table_size = ((size_t)1) << params.log_table_size;
+  agups_table<Word> arr(world, global_table_size);
+
+  output["NAME"]                     = "AGUPS_YGM";
+  output["MODE"]                     = "RECURSIVE";
+  output["TIME"]                     = boost::json::array();
+  output["GUPS"]                     = boost::json::array();
+  output["GENERATION_TIME"]          = boost::json::array();
+  output["GLOBAL_ASYNC_COUNT"]       = boost::json::array();
+  output["GLOBAL_ISEND_COUNT"]       = boost::json::array();
+  output["GLOBAL_ISEND_BYTES"]       = boost::json::array();
+  output["MAX_WAITSOME_ISEND_IRECV"] = boost::json::array();
+  output["MAX_WAITSOME_IALLREDUCE"]  = boost::json::array();
+  output["COUNT_IALLREDUCE"]         = boost::json::array();
+  output["TABLE_SIZE"]               = global_table_size;
+  output["UPDATERS"]                 = params.local_updaters * world.size();
+  output["UPDATER_LIFESPAN"]         = params.updater_lifetime;
+  output["GENERATION_THREADS"]       = params.num_threads;
+  output["WORD_BITS"]                = sizeof(Word) * 8;
+  output["LOCAL_HOPS"]               = params.local_hops;
+  output["BATCHED_VISITS"]           = params.batched_visits;
+  output["LOCAL_HOP_FRACTION"]       = boost::json::array();
+  if (params.batched_visits) {
+    output["BATCH_ROUNDS"] = boost::json::array();
+  }
+  output["PAYLOAD_BYTES"]    = params.payload_bytes;
+  output["MESSAGES_PER_SEC"] = boost::json::array();
+  output["GB_PER_SEC"]       = boost::json::array();
+  output["MEASURE_LATENCY"]  = params.measure_latency;
+  if (params.measure_latency) {
+    for (const auto &[suffix, q] : latency_percentiles) {
+      output["HOP_LATENCY_" + suffix + "_NS"]      = boost::json::array();
+      output["UPDATER_LIFETIME_" + suffix + "_NS"] = boost::json::array();
+    }
+  }
 
-    size_t global_table_size = ((size_t)1) << params.log_table_size;
-    ygm::container::array<size_t> arr(world, global_table_size);
+  parse_welcome(world, output);
 
-    boost::json::object output;
+  std::mt19937                        gen(world.rank());
+  std::uniform_int_distribution<Word> dist;
+
+  arr.for_all(
+      [&dist, &gen](const auto index, auto &value) { value = dist(gen); });
+
+  world.cf_barrier();
 
-    output["NAME"]                     = "AGUPS_YGM";
-    output["TIME"]                     = boost::json::array();
-    output["GUPS"]                     = boost::json::array();
-    output["GLOBAL_ASYNC_COUNT"]       = boost::json::array();
-    output["GLOBAL_ISEND_COUNT"]       = boost::json::array();
-    output["GLOBAL_ISEND_BYTES"]       = boost::json::array();
-    output["MAX_WAITSOME_ISEND_IRECV"] = boost::json::array();
-    output["MAX_WAITSOME_IALLREDUCE"]  = boost::json::array();
-    output["COUNT_IALLREDUCE"]         = boost::json::array();
-    output["TABLE_SIZE"]               = global_table_size;
-    output["UPDATERS"]                 = params.local_updaters * world.size();
-    output["UPDATER_LIFESPAN"]         = params.updater_lifetime;
+  memory.record("CONTAINER_INIT");
+
+  if (params.measure_latency) {
+    clock_offset offset = estimate_clock_offset(world.get_mpi_comm());
+    s_clock_offset_ns   = offset.offset_ns;
+
+    output["CLOCK_SYNC_MAX_RTT_NS"] = ygm::max(offset.rtt_ns, world);
+  }
+
+  for (int trial = 0; trial < params.num_trials; ++trial) {
+    world.stats_reset();
+    reset_peak_rss();
+
+    ygm::utility::timer generation_timer{};
+
+    // Updater seeds come from counter-based substreams, so the updaters do
+    // not depend on the number of threads
+    std::vector<updater<Word>> updater_vec(params.local_updaters);
+    uint64_t first_updater = world.rank() * params.local_updaters;
+    parallel_for_blocks(
+        params.num_threads, updater_vec.size(),
+        [&updater_vec, first_updater, trial](const uint64_t begin,
+                                             const uint64_t end) {
+          for (uint64_t i = begin; i < end; ++i) {
+            counter_random_stream stream(trial, first_updater + i);
+            updater_vec[i] = updater<Word>(stream.next());
+          }
+        });
+
+    world.barrier();
+
+    double generation_time = generation_timer.elapsed();
+
+    memory.record("INPUT_GENERATED");
+    memory.start_sampling();
+
+    s_local_hops = 0;
+    s_hop_latencies.clear();
+    s_lifetime_latencies.clear();
+    updater_batches<Word> batches(world.size());
+    uint64_t              rounds{0};
+
+    ygm::utility::timer update_timer{};
+
+    updater_batches<Word> *pending = params.batched_visits ? &batches : nullptr;
+    for (auto &u : updater_vec) {
+      if (params.measure_latency) {
+        u.start_clock(updater_clock_ns());
+      }
+      send_updater(arr, u, pending);
+    }
+
+    // Each round sends every queued updater and runs the visits, which queue
+    // the updaters for the next round
+    while (params.batched_visits &&
+           !ygm::logical_and(
+               std::all_of(batches.begin(), batches.end(),
+                           [](const auto &batch) { return batch.empty(); }),
+               world)) {
+      for (int rank = 0; rank < world.size(); ++rank) {
+        // Visits run while sending may queue more updaters for rank
+        std::vector<updater<Word>> batch;
+        batch.swap(batches[rank]);
+        if (!batch.empty()) {
+          world.async(rank, batch_functor<Word>(), world.make_ygm_ptr(arr),
+                      world.make_ygm_ptr(batches), batch);
+        }
+      }
+      world.barrier();
+      ++rounds;
+    }
 
-    parse_welcome(world, output);
+    world.barrier();
 
-    std::mt19937                          gen(world.rank());
-    std::uniform_int_distribution<size_t> dist;
+    double trial_time = update_timer.elapsed();
+    memory.record("KERNEL");
 
-    arr.for_all(
-        [&dist, &gen](const auto index, auto &value) { value = dist(gen); });
+    uint64_t global_hops =
+        params.local_updaters * world.size() * params.updater_lifetime;
 
-    world.cf_barrier();
+    uint64_t global_local_hops = ygm::sum(s_local_hops, world);
 
-    for (int trial = 0; trial < params.num_trials; ++trial) {
-      world.stats_reset();
+    double trial_gups = global_hops / trial_time / (1000 * 1000 * 1000);
 
-      std::vector<updater> updater_vec;
+    // Messages are counted by YGM, since one message carries a whole batch
+    // of updaters with -B.  Every hop not run inline carries a payload.
+    double messages_per_sec =
+        read_stat(world, "GLOBAL_ASYNC_COUNT") / trial_time;
+    double payload_gb_per_sec = (global_hops - global_local_hops) *
+                                params.payload_bytes / trial_time /
+                                (1000 * 1000 * 1000);
 
-      for (int64_t i = 0; i < params.local_updaters; ++i) {
-        updater_vec.emplace_back(updater(dist(gen)));
+    output["TIME"].as_array().emplace_back(trial_time);
+    output["GUPS"].as_array().emplace_back(trial_gups);
+    output["GENERATION_TIME"].as_array().emplace_back(generation_time);
+    output["LOCAL_HOP_FRACTION"].as_array().emplace_back(
+        double(global_local_hops) / global_hops);
+    output["MESSAGES_PER_SEC"].as_array().emplace_back(messages_per_sec);
+    output["GB_PER_SEC"].as_array().emplace_back(payload_gb_per_sec);
+    if (params.batched_visits) {
+      output["BATCH_ROUNDS"].as_array().emplace_back(rounds);
+    }
+    if (params.measure_latency) {
+      s_hop_latencies.merge(world.get_mpi_comm());
+      s_lifetime_latencies.merge(world.get_mpi_comm());
+      for (const auto &[suffix, q] : latency_percentiles) {
+        output["HOP_LATENCY_" + suffix + "_NS"].as_array().emplace_back(
+            s_hop_latencies.percentile(q));
+        output["UPDATER_LIFETIME_" + suffix + "_NS"].as_array().emplace_back(
+            s_lifetime_latencies.percentile(q));
       }
+    }
 
-      world.barrier();
+    parse_stats(world, output);
+  }
+}
+
+// Table of HPCC RandomAccess, whose entries and updates are 64-bit
+using hpcc_table = ygm::container::array<uint64_t, uint64_t>;
 
-      ygm::utility::timer update_timer{};
+// XORs ran into the entry of table it selects, which must be local
+void apply_hpcc_update(hpcc_table &table, const uint64_t ran) {
+  table.local_visit(ran & (table.size() - 1),
+                    [ran](const uint64_t index, uint64_t &value) {
+                      value ^= ran;
+                    });
+}
+
+struct hpcc_update_functor {
+ public:
+  void operator()(ygm::ygm_ptr<hpcc_table>     ptable,
+                  const std::vector<uint64_t> &updates) const {
+    for (const auto ran : updates) {
+      apply_hpcc_update(*ptable, ran);
+    }
+  }
+};
 
-      for (auto &u : updater_vec) {
-        size_t first_index = u.get_state() & (arr.size() - 1);
-        arr.async_visit(first_index, recursive_functor(), u);
+// Applies this rank's share of the HPCC update stream.  As in HPCC's
+// look-ahead, updates are bucketed by owner and a bucket is sent once it
+// holds params.hpcc_bucket_size updates.
+void run_hpcc_updates(ygm::comm &world, hpcc_table &table,
+                      const uint64_t first_update, const uint64_t num_updates) {
+  std::vector<std::vector<uint64_t>> buckets(world.size());
+  auto                               ptable = world.make_ygm_ptr(table);
+  hpcc_random_stream                 stream(first_update);
+
+  for (uint64_t i = 0; i < num_updates; ++i) {
+    uint64_t ran   = stream.next();
+    int      owner = table.partitioner.owner(ran & (table.size() - 1));
+
+    if (owner == world.rank()) {
+      apply_hpcc_update(table, ran);
+    } else {
+      buckets[owner].push_back(ran);
+      if (buckets[owner].size() == uint64_t(params.hpcc_bucket_size)) {
+        world.async(owner, hpcc_update_functor(), ptable, buckets[owner]);
+        buckets[owner].clear();
       }
+    }
+  }
 
-      world.barrier();
+  for (int rank = 0; rank < world.size(); ++rank) {
+    if (!buckets[rank].empty()) {
+      world.async(rank, hpcc_update_functor(), ptable, buckets[rank]);
+    }
+  }
 
-      double trial_time = update_timer.elapsed();
-      double trial_gups = params.local_updaters * world.size() *
-                          params.updater_lifetime / trial_time /
-                          (1000 * 1000 * 1000);
+  world.barrier();
+}
 
-      output["TIME"].as_array().emplace_back(trial_time);
-      output["GUPS"].as_array().emplace_back(trial_gups);
+// Undoes the updates to this rank's entries without communication: every
+// rank regenerates the whole update stream serially and XORs in the updates
+// it owns again, which restores each entry to its index, since XOR is its own
+// inverse.  The kernel's bucketing and messaging are not involved, so their
+// errors are not replayed.
+void undo_hpcc_updates(ygm::comm &world, hpcc_table &table,
+                       const uint64_t global_updates) {
+  hpcc_random_stream stream(0);
+
+  for (uint64_t i = 0; i < global_updates; ++i) {
+    uint64_t ran   = stream.next();
+    uint64_t index = ran & (table.size() - 1);
+
+    if (table.partitioner.owner(index) == world.rank()) {
+      table.local_visit(index, [ran](const uint64_t index, uint64_t &value) {
+        value ^= ran;
+      });
+    }
+  }
+
+  world.barrier();
+}
 
-      parse_stats(world, output);
+// Runs HPCC RandomAccess: 4 updates per table entry, split evenly across
+// ranks.  Verification undoes the updates independently of the kernel and
+// counts the entries that do not return to their index.
+void run_hpcc(ygm::comm &world, memory_profile &memory,
+              boost::json::object &output) {
+  uint64_t   global_table_size = ((uint64_t)1) << params.log_table_size;
+  uint64_t   global_updates    = 4 * global_table_size;
+  hpcc_table table(world, global_table_size);
+
+  output["NAME"]                     = "AGUPS_YGM";
+  output["MODE"]                     = "HPCC_RANDOM_ACCESS";
+  output["TIME"]                     = boost::json::array();
+  output["GUPS"]                     = boost::json::array();
+  output["VERIFICATION_TIME"]        = boost::json::array();
+  output["ERROR_FRACTION"]           = boost::json::array();
+  output["VERIFIED"]                 = boost::json::array();
+  output["GLOBAL_ASYNC_COUNT"]       = boost::json::array();
+  output["GLOBAL_ISEND_COUNT"]       = boost::json::array();
+  output["GLOBAL_ISEND_BYTES"]       = boost::json::array();
+  output["MAX_WAITSOME_ISEND_IRECV"] = boost::json::array();
+  output["MAX_WAITSOME_IALLREDUCE"]  = boost::json::array();
+  output["COUNT_IALLREDUCE"]         = boost::json::array();
+  output["TABLE_SIZE"]               = global_table_size;
+  output["UPDATES"]                  = global_updates;
+  output["BUCKET_SIZE"]              = params.hpcc_bucket_size;
+  output["WORD_BITS"]                = 64;
+
+  parse_welcome(world, output);
+
+  uint64_t min_updates   = global_updates / world.size();
+  uint64_t local_updates =
+      min_updates + (uint64_t(world.rank()) < global_updates % world.size());
+  uint64_t first_update =
+      world.rank() * min_updates +
+      std::min<uint64_t>(world.rank(), global_updates % world.size());
+
+  for (int trial = 0; trial < params.num_trials; ++trial) {
+    table.for_all([](const uint64_t index, uint64_t &value) { value = index; });
+    world.barrier();
+
+    memory.record("CONTAINER_INIT");
+    world.stats_reset();
+    reset_peak_rss();
+    memory.start_sampling();
+
+    world.barrier();
+    ygm::utility::timer update_timer{};
+
+    run_hpcc_updates(world, table, first_update, local_updates);
+
+    double trial_time = update_timer.elapsed();
+    memory.record("KERNEL");
+
+    // Statistics cover the timed updates only
+    parse_stats(world, output);
+
+    ygm::utility::timer verification_timer{};
+
+    undo_hpcc_updates(world, table, global_updates);
+
+    uint64_t local_errors{0};
+    table.for_all([&local_errors](const uint64_t index, uint64_t &value) {
+      local_errors += value != index;
+    });
+    double error_fraction =
+        double(ygm::sum(local_errors, world)) / global_table_size;
+
+    double verification_time = verification_timer.elapsed();
+
+    output["TIME"].as_array().emplace_back(trial_time);
+    output["GUPS"].as_array().emplace_back(global_updates / trial_time /
+                                           (1000 * 1000 * 1000));
+    output["VERIFICATION_TIME"].as_array().emplace_back(verification_time);
+    output["ERROR_FRACTION"].as_array().emplace_back(error_fraction);
+    // HPCC accepts up to 1% of entries in error
+    output["VERIFIED"].as_array().emplace_back(error_fraction <= 0.01);
+  }
+}
+
+int main(int argc, char **argv) {
+  {
+    ygm::comm world(&argc, &argv);
+
+    params = parse_cmd_line(argc, argv, world);
+    message_payload::set_size(params.payload_bytes);
+
+    // Tables of fewer than 2^32 entries use 32-bit entries, indices and
+    // updater state unless -W 64 is given
+    bool narrow = params.word_bits == 32 ||
+                  (params.word_bits == 0 && params.log_table_size < 32);
+
+    boost::json::object output;
+    memory_profile      memory(world.get_mpi_comm(), output);
+    memory.record("STARTUP");
+
+    if (params.hpcc) {
+      run_hpcc(world, memory, output);
+    } else if (narrow) {
+      run_agups<uint32_t>(world, memory, output);
+    } else {
+      run_agups<uint64_t>(world, memory, output);
     }
 
+    memory.record("TEARDOWN");
+
     if (params.pretty_print) {
       pretty_print(world.cout0(), output);
       world.cout0() << "\n";
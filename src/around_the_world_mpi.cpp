@@ -6,6 +6,7 @@
 #include <mpi.h>
 #include <cstdlib>
 #include <iostream>
+#include <memory_profile.hpp>
 #include <utility.hpp>
 
 #include <boost/json/src.hpp>
@@ -104,7 +105,12 @@ int main(int argc, char **argv) {
   output["NUM_TRIPS"]  = params.num_trips;
   output["TOTAL_HOPS"] = total_hops;
 
+  memory_profile memory(MPI_COMM_WORLD, output);
+  memory.record("STARTUP");
+
   for (int trial = 0; trial < params.num_trials; ++trial) {
+    reset_peak_rss();
+    memory.start_sampling();
     MPI_Barrier(MPI_COMM_WORLD);
     double start = MPI_Wtime();
 
@@ -124,11 +130,14 @@ int main(int argc, char **argv) {
 
     MPI_Barrier(MPI_COMM_WORLD);
     double elapsed = MPI_Wtime() - start;
+    memory.record("KERNEL");
 
     output["TIME"].as_array().emplace_back(elapsed);
     output["HOPS_PER_SEC"].as_array().emplace_back(total_hops / elapsed);
   }
 
+  memory.record("TEARDOWN");
+
   if (mpi_rank == 0) {
     if (params.pretty_print) {
       pretty_print(std::cout, output);
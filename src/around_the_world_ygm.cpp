@@ -5,6 +5,8 @@
 
 #include <unistd.h>
 #include <algorithm>
+#include <memory_profile.hpp>
+#include <message_payload.hpp>
 #include <string>
 #include <utility.hpp>
 #include <ygm/comm.hpp>
@@ -13,14 +15,16 @@
 #include <boost/json/src.hpp>
 
 struct parameters_t {
-  int  num_trips;
-  int  num_trials;
-  bool use_wait_until;
-  bool pretty_print;
+  int     num_trips;
+  int     num_trials;
+  int64_t payload_bytes;
+  bool    use_wait_until;
+  bool    pretty_print;
 
   parameters_t()
       : num_trips(1000),
         num_trials(5),
+        payload_bytes(0),
         use_wait_until(false),
         pretty_print(false) {}
 };
@@ -29,6 +33,8 @@ void usage(ygm::comm &comm) {
   comm.cerr0() << "around_the_world_ygm usage:"
                << "\n\t-n <int>\t- Number of trips around the world"
                << "\n\t-t <int>\t- Number of trials"
+               << "\n\t-b <int>\t- Bytes of payload carried by each hop "
+                  "(default 0)"
                << "\n\t-w\t\t- Use ygm::comm::wait_until()"
                << "\n\t-p\t\t- Pretty print output"
                << "\n\t-h\t\t- Print help" << std::endl;
@@ -43,7 +49,7 @@ parameters_t parse_cmd_line(int argc, char **argv, ygm::comm &comm) {
   extern int opterr;
   opterr = 0;
 
-  while ((c = getopt(argc, argv, "n:t:wph")) != -1) {
+  while ((c = getopt(argc, argv, "n:t:b:wph")) != -1) {
     switch (c) {
       case 'h':
         prn_help = true;
@@ -54,6 +60,9 @@ parameters_t parse_cmd_line(int argc, char **argv, ygm::comm &comm) {
       case 't':
         params.num_trials = atoi(optarg);
         break;
+      case 'b':
+        params.payload_bytes = atoll(optarg);
+        break;
       case 'w':
         params.use_wait_until = true;
         break;
@@ -67,6 +76,11 @@ parameters_t parse_cmd_line(int argc, char **argv, ygm::comm &comm) {
     }
   }
 
+  if (params.payload_bytes < 0) {
+    comm.cerr0() << "Payload size (-b) cannot be negative" << std::endl;
+    prn_help = true;
+  }
+
   if (prn_help) {
     usage(comm);
     exit(-1);
@@ -84,6 +98,7 @@ void run_atw(ygm::comm &world, const parameters_t &params) {
   output["NAME"]                     = "ATW_YGM";
   output["TIME"]                     = boost::json::array();
   output["HOPS_PER_SEC"]             = boost::json::array();
+  output["GB_PER_SEC"]               = boost::json::array();
   output["GLOBAL_ASYNC_COUNT"]       = boost::json::array();
   output["GLOBAL_ISEND_COUNT"]       = boost::json::array();
   output["GLOBAL_ISEND_BYTES"]       = boost::json::array();
@@ -93,18 +108,24 @@ void run_atw(ygm::comm &world, const parameters_t &params) {
   output["WAIT_UNTIL"]               = params.use_wait_until;
   output["NUM_TRIPS"]                = params.num_trips;
   output["TOTAL_HOPS"]               = total_hops;
+  output["PAYLOAD_BYTES"]            = params.payload_bytes;
 
   parse_welcome(world, output);
 
+  memory_profile memory(world.get_mpi_comm(), output);
+  memory.record("STARTUP");
+
   static int curr_trip;
   curr_trip = 0;
 
+  // Each hop is one message carrying a payload of params.payload_bytes
   struct around_the_world_functor {
    public:
-    void operator()(ygm::ygm_ptr<ygm::comm> pworld) {
+    void operator()(ygm::ygm_ptr<ygm::comm> pworld,
+                    const message_payload  &payload) {
       if (curr_trip < s_params.num_trips) {
         pworld->async((pworld->rank() + 1) % pworld->size(),
-                      around_the_world_functor());
+                      around_the_world_functor(), payload);
         ++curr_trip;
       }
     }
@@ -117,12 +138,14 @@ void run_atw(ygm::comm &world, const parameters_t &params) {
 
     curr_trip = 0;
 
+    reset_peak_rss();
+    memory.start_sampling();
     world.barrier();
 
     ygm::utility::timer trip_timer{};
 
     if (world.rank0()) {
-      world.async(1, around_the_world_functor());
+      world.async(1, around_the_world_functor(), message_payload());
     }
 
     if (params.use_wait_until) {
@@ -132,13 +155,18 @@ void run_atw(ygm::comm &world, const parameters_t &params) {
     world.barrier();
 
     double elapsed = trip_timer.elapsed();
+    memory.record("KERNEL");
 
     output["TIME"].as_array().emplace_back(elapsed);
     output["HOPS_PER_SEC"].as_array().emplace_back(total_hops / elapsed);
+    output["GB_PER_SEC"].as_array().emplace_back(
+        total_hops * params.payload_bytes / elapsed / (1000 * 1000 * 1000));
 
     parse_stats(world, output);
   }
 
+  memory.record("TEARDOWN");
+
   if (params.pretty_print) {
     pretty_print(world.cout0(), output);
     world.cout0() << "\n";
@@ -152,6 +180,7 @@ int main(int argc, char **argv) {
 
   // Need static params to use in around_the_world_functor
   parameters_t params = parse_cmd_line(argc, argv, world);
+  message_payload::set_size(params.payload_bytes);
 
   /* wait_until currently unimplemented
 bool        wait_until{false};
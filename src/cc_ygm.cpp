@@ -3,8 +3,16 @@
 //
 // SPDX-License-Identifier: MIT
 
+#include <binary_array_file.hpp>
+#include <distributed_cc.hpp>
+#include <edge_list_reader.hpp>
+#include <latency_histogram.hpp>
+#include <limits>
+#include <memory_profile.hpp>
 #include <random>
 #include <rmat_edge_generator.hpp>
+#include <serial_union_find.hpp>
+#include <synthetic_edge_generator.hpp>
 #include <utility.hpp>
 #include <ygm/comm.hpp>
 #include <ygm/container/disjoint_set.hpp>
@@ -13,19 +21,46 @@
 #include <boost/json/src.hpp>
 
 struct parameters_t {
-  enum class generator { rmat, linked_list };
+  enum class generator { rmat, linked_list, file, synthetic };
+  enum class algorithm_type { disjoint_set, fastsv, label_propagation };
 
-  int       graph_scale;
-  int       edgefactor;
-  int       num_trials;
-  generator gen;
-  bool      pretty_print;
+  int                     graph_scale;
+  int                     edgefactor;
+  int                     num_trials;
+  generator               gen;
+  algorithm_type          algorithm;
+  synthetic_graph         graph;
+  synthetic_graph_options graph_options;
+  rmat_parameters         rmat;
+  std::string             input_path;
+  edge_list_format        input_format;
+  rmat_rng                rng;
+  int                     num_threads;
+  bool                    stream;
+  uint64_t                batch_size;
+  bool                    batch_barrier;
+  int64_t                 queries;
+  std::string             cache_dir;
+  bool                    precontract;
+  bool                    verify;
+  bool                    pretty_print;
 
   parameters_t()
       : graph_scale(15),
         edgefactor(16),
         num_trials(5),
         gen(generator::rmat),
+        algorithm(algorithm_type::disjoint_set),
+        graph(synthetic_graph::erdos_renyi),
+        input_format(edge_list_format::text),
+        rng(rmat_rng::sequential),
+        num_threads(1),
+        stream(false),
+        batch_size(0),
+        batch_barrier(false),
+        queries(0),
+        precontract(false),
+        verify(false),
         pretty_print(false) {}
 };
 
@@ -34,6 +69,47 @@ void usage(ygm::comm &comm) {
                << "\n\t-g <int>\t- Log_2 of global number of vertices"
                << "\n\t-e <int>\t- Edgefactor (half of average vertex degree)"
                << "\n\t-l\t\t- Use linked-list graph"
+               << "\n\t-R <str>\t- RMAT quadrant probabilities a,b,c,d "
+                  "(default 0.57,0.19,0.19,0.05)"
+               << "\n\t-S <str>\t- RMAT vertex scrambler (none, hash, "
+                  "feistel)"
+               << "\n\t-U\t\t- Undirected RMAT graph (both orientations "
+                  "of each edge are unioned)"
+               << "\n\t-d <str>\t- Graph generator (rmat, linked_list, er, "
+                  "zipf, chung_lu, grid2d, grid3d, torus2d, torus3d, "
+                  "block_local)"
+               << "\n\t-z <float>\t- Zipf exponent of zipf graphs"
+               << "\n\t-G <float>\t- Power-law degree exponent of "
+                  "chung_lu graphs"
+               << "\n\t-L <float>\t- Fraction of block_local endpoints "
+                  "owned by the generating rank (requires -a fastsv or "
+                  "labelprop)"
+               << "\n\t-f <str>\t- Read edges from a file or directory "
+                  "instead of generating them"
+               << "\n\t-F <str>\t- Format of files read with -f (text, "
+                  "binary)"
+               << "\n\t-I\t\t- Generate the same RMAT graph for any number "
+                  "of ranks and threads"
+               << "\n\t-T <int>\t- Number of threads generating edges per "
+                  "rank (implies -I when above 1)"
+               << "\n\t-m\t\t- Streaming mode (edges are sent as they are "
+                  "generated)"
+               << "\n\t-b <int>\t- Number of edges per rank generated and "
+                  "sent as one batch (implies -m; default 0, unbatched)"
+               << "\n\t-q\t\t- Barrier after each batch of -b, bounding "
+                  "the unions in flight"
+               << "\n\t-Q <int>\t- Same-component queries per rank "
+                  "after each batch of -b (implies -q; requires -a dset)"
+               << "\n\t-c\t\t- Contract each rank's edges (or each batch "
+                  "of -b) with a serial union-find and send only its "
+                  "spanning forest"
+               << "\n\t-C <str>\t- Directory for caching generated edges "
+                  "across trials and runs"
+               << "\n\t-a <str>\t- Algorithm (dset, fastsv, labelprop; "
+                  "default dset)"
+               << "\n\t-V\t\t- Verify the number of components (linked "
+                  "lists against the known answer, other graphs against a "
+                  "serial union-find of all edges on rank 0)"
                << "\n\t-t <int>\t- Number of trials"
                << "\n\t-p\t\t- Pretty print output"
                << "\n\t-h\t\t- Print help" << std::endl;
@@ -48,7 +124,8 @@ parameters_t parse_cmd_line(int argc, char **argv, ygm::comm &comm) {
   extern int opterr;
   opterr = 0;
 
-  while ((c = getopt(argc, argv, "g:e:lt:ph")) != -1) {
+  while ((c = getopt(argc, argv,
+                     "g:e:lR:S:Ud:z:G:L:f:F:IT:mb:qQ:cC:a:Vt:ph")) != -1) {
     switch (c) {
       case 'h':
         prn_help = true;
@@ -62,6 +139,98 @@ parameters_t parse_cmd_line(int argc, char **argv, ygm::comm &comm) {
       case 'l':
         params.gen = parameters_t::generator::linked_list;
         break;
+      case 'R':
+        if (!parse_rmat_probabilities(optarg, params.rmat)) {
+          comm.cerr0() << "Invalid RMAT probabilities: " << optarg
+                       << std::endl;
+          prn_help = true;
+        }
+        break;
+      case 'S':
+        if (!parse_rmat_scrambler(optarg, params.rmat)) {
+          comm.cerr0() << "Unrecognized scrambler: " << optarg << std::endl;
+          prn_help = true;
+        }
+        break;
+      case 'U':
+        params.rmat.undirected = true;
+        break;
+      case 'd':
+        if (std::string(optarg) == "rmat") {
+          params.gen = parameters_t::generator::rmat;
+        } else if (std::string(optarg) == "linked_list") {
+          params.gen = parameters_t::generator::linked_list;
+        } else if (parse_synthetic_graph(optarg, params.graph)) {
+          params.gen = parameters_t::generator::synthetic;
+        } else {
+          comm.cerr0() << "Unrecognized graph generator: " << optarg
+                       << std::endl;
+          prn_help = true;
+        }
+        break;
+      case 'z':
+        params.graph_options.zipf_exponent = atof(optarg);
+        break;
+      case 'G':
+        params.graph_options.power_law_exponent = atof(optarg);
+        break;
+      case 'L':
+        params.graph_options.local_fraction = atof(optarg);
+        break;
+      case 'f':
+        params.gen        = parameters_t::generator::file;
+        params.input_path = optarg;
+        break;
+      case 'F':
+        if (std::string(optarg) == "text") {
+          params.input_format = edge_list_format::text;
+        } else if (std::string(optarg) == "binary") {
+          params.input_format = edge_list_format::binary;
+        } else {
+          comm.cerr0() << "Unrecognized edge list format: " << optarg
+                       << std::endl;
+          prn_help = true;
+        }
+        break;
+      case 'I':
+        params.rng = rmat_rng::counter;
+        break;
+      case 'T':
+        params.num_threads = atoi(optarg);
+        break;
+      case 'm':
+        params.stream = true;
+        break;
+      case 'b':
+        params.batch_size = atoll(optarg);
+        break;
+      case 'q':
+        params.batch_barrier = true;
+        break;
+      case 'Q':
+        params.queries = atoll(optarg);
+        break;
+      case 'c':
+        params.precontract = true;
+        break;
+      case 'C':
+        params.cache_dir = optarg;
+        break;
+      case 'a':
+        if (std::string(optarg) == "dset") {
+          params.algorithm = parameters_t::algorithm_type::disjoint_set;
+        } else if (std::string(optarg) == "fastsv") {
+          params.algorithm = parameters_t::algorithm_type::fastsv;
+        } else if (std::string(optarg) == "labelprop") {
+          params.algorithm = parameters_t::algorithm_type::label_propagation;
+        } else {
+          comm.cerr0() << "Unrecognized algorithm: " << optarg << std::endl;
+          prn_help = true;
+        }
+        break;
+      case 'V':
+        params.verify = true;
+        break;
       case 't':
         params.num_trials = atoi(optarg);
         break;
@@ -75,6 +244,95 @@ parameters_t parse_cmd_line(int argc, char **argv, ygm::comm &comm) {
     }
   }
 
+  if (params.num_threads < 1) {
+    comm.cerr0() << "Number of threads (-T) must be positive" << std::endl;
+    prn_help = true;
+  }
+
+  // Written to reject NaN as well
+  if (!(params.graph_options.power_law_exponent > 1.0)) {
+    comm.cerr0() << "Power-law exponent (-G) must be greater than 1"
+                 << std::endl;
+    prn_help = true;
+  }
+
+  if (!(params.graph_options.local_fraction >= 0.0 &&
+        params.graph_options.local_fraction <= 1.0)) {
+    comm.cerr0() << "Local fraction (-L) must be between 0 and 1" << std::endl;
+    prn_help = true;
+  }
+
+  // block_local locality follows the cyclic partition of fastsv and labelprop;
+  // disjoint_set hashes its vertices
+  if (params.gen == parameters_t::generator::synthetic &&
+      params.graph == synthetic_graph::block_local) {
+    params.graph_options.cyclic_blocks = true;
+    if (params.algorithm == parameters_t::algorithm_type::disjoint_set) {
+      comm.cerr0() << "block_local graphs require a cyclically partitioned "
+                      "algorithm (-a fastsv or -a labelprop)"
+                   << std::endl;
+      prn_help = true;
+    }
+  }
+
+  // Threads generate disjoint ranges of edges, which requires counter-based
+  // generation
+  if (params.num_threads > 1) {
+    params.rng = rmat_rng::counter;
+  }
+
+  // Batches are generated as they are sent rather than stored
+  if (params.batch_size > 0) {
+    params.stream = true;
+  }
+
+  // Queries see every union of the batches before them
+  if (params.queries > 0) {
+    params.batch_barrier = true;
+  }
+
+  if (params.queries > 0 && (params.batch_size == 0 ||
+                             params.algorithm !=
+                                 parameters_t::algorithm_type::disjoint_set)) {
+    comm.cerr0() << "Queries between batches (-Q) require a batch size (-b) "
+                    "and the disjoint_set algorithm (-a dset)"
+                 << std::endl;
+    prn_help = true;
+  }
+
+  if (params.batch_barrier && params.batch_size == 0) {
+    comm.cerr0() << "Barriers between batches (-q) require a batch size (-b)"
+                 << std::endl;
+    prn_help = true;
+  }
+
+  if (params.precontract && params.stream && params.batch_size == 0) {
+    comm.cerr0() << "Pre-contraction (-c) needs stored edges or batches (-b) "
+                    "and cannot be combined with unbatched streaming (-m)"
+                 << std::endl;
+    prn_help = true;
+  }
+
+  if (params.gen == parameters_t::generator::file) {
+    if (!std::filesystem::exists(params.input_path)) {
+      comm.cerr0() << "Edge list not found: " << params.input_path
+                   << std::endl;
+      prn_help = true;
+    }
+    if (!params.cache_dir.empty()) {
+      comm.cerr0() << "Edge caching (-C) only applies to generated graphs"
+                   << std::endl;
+      prn_help = true;
+    }
+  }
+
+  if (params.stream && !params.cache_dir.empty()) {
+    comm.cerr0() << "Edge caching (-C) requires stored edges and cannot be "
+                    "combined with streaming (-m or -b)"
+                 << std::endl;
+    prn_help = true;
+  }
+
   if (prn_help) {
     usage(comm);
     exit(-1);
@@ -83,32 +341,109 @@ parameters_t parse_cmd_line(int argc, char **argv, ygm::comm &comm) {
   return params;
 }
 
+// First source vertex and number of source vertices owned by this rank in the
+// linked-list graph
+std::pair<uint64_t, uint64_t> linked_list_sources(ygm::comm     &world,
+                                                  const uint64_t num_vertices) {
+  // Skip last vertex as source (only a sink) by using num_vertices-1
+  uint64_t min_block_size = (num_vertices - 1) / world.size();
+  uint64_t num_local_sources =
+      min_block_size + (world.rank() < (num_vertices - 1) % world.size());
+  uint64_t vertex_offset =
+      world.rank() * min_block_size +
+      std::min<uint64_t>(world.rank(), (num_vertices - 1) % world.size());
+
+  return std::make_pair(vertex_offset, num_local_sources);
+}
+
+// Number of edges in a synthetic graph.  Lattices have a fixed number of
+// edges; other graphs have edgefactor edges per vertex.
+uint64_t synthetic_edge_count(const parameters_t &params) {
+  uint64_t lattice_edges = synthetic_edge_generator::lattice_edge_count(
+      params.graph, params.graph_scale);
+  if (lattice_edges > 0) {
+    return lattice_edges;
+  }
+
+  return (((uint64_t)1) << params.graph_scale) * params.edgefactor;
+}
+
+distributed_rmat_edge_generator make_rmat_generator(ygm::comm          &world,
+                                                    const parameters_t &params,
+                                                    const int           trial) {
+  uint64_t num_vertices = ((uint64_t)1) << params.graph_scale;
+
+  return distributed_rmat_edge_generator(
+      world, params.graph_scale, num_vertices * params.edgefactor, trial,
+      params.rmat.scramble, params.rmat.undirected, params.rmat.a,
+      params.rmat.b, params.rmat.c, params.rmat.d, params.rng,
+      params.rmat.scrambler);
+}
+
 std::vector<std::pair<uint64_t, uint64_t>> generate_edges(
-    ygm::comm &world, const int graph_scale, const int edgefactor,
-    const int trial, const parameters_t::generator gen) {
+    ygm::comm &world, const parameters_t &params, const int trial) {
   std::vector<std::pair<uint64_t, uint64_t>> edges;
-  uint64_t num_vertices = ((uint64_t)1) << graph_scale;
-
-  if (gen == parameters_t::generator::rmat) {
-    uint64_t                        global_edges = num_vertices * edgefactor;
-    distributed_rmat_edge_generator rmat(world, graph_scale, global_edges,
-                                         trial);
-
-    rmat.for_all([&edges](const auto first, const auto second) {
-      edges.push_back(std::make_pair(first, second));
-    });
-  } else if (gen == parameters_t::generator::linked_list) {
-    // Skip last vertex as source (only a sink) by using num_vertices-1
-    uint64_t min_block_size = (num_vertices - 1) / world.size();
-    uint64_t num_local_sources =
-        min_block_size + (world.rank() < (num_vertices - 1) % world.size());
-    uint64_t vertex_offset =
-        world.rank() * min_block_size +
-        std::min<uint64_t>(world.rank(), (num_vertices - 1) % world.size());
+  uint64_t num_vertices = ((uint64_t)1) << params.graph_scale;
 
-    for (uint64_t i = 0; i < num_local_sources; ++i) {
-      edges.push_back(std::make_pair(vertex_offset + i, vertex_offset + i + 1));
+  if (params.gen == parameters_t::generator::rmat) {
+    auto rmat = make_rmat_generator(world, params, trial);
+
+    // Reversed edges of undirected graphs follow all of the generated edges
+    uint64_t num_generated = rmat.local_size();
+    edges.resize(params.rmat.undirected ? 2 * num_generated : num_generated);
+    std::span<rmat_edge_generator::edge_type> generated(edges.data(),
+                                                        num_generated);
+    if (rmat.is_counter_based()) {
+      parallel_for_blocks(
+          params.num_threads, num_generated,
+          [&rmat, &generated](const uint64_t begin, const uint64_t end) {
+            rmat.generate_batch(begin, generated.subspan(begin, end - begin));
+          });
+    } else {
+      rmat.generate_batch(generated);
     }
+
+    if (params.rmat.undirected) {
+      parallel_for_blocks(
+          params.num_threads, num_generated,
+          [&edges, num_generated](const uint64_t begin, const uint64_t end) {
+            for (uint64_t i = begin; i < end; ++i) {
+              edges[num_generated + i] =
+                  std::make_pair(edges[i].second, edges[i].first);
+            }
+          });
+    }
+  } else if (params.gen == parameters_t::generator::linked_list) {
+    auto [vertex_offset, num_local_sources] =
+        linked_list_sources(world, num_vertices);
+
+    edges.resize(num_local_sources);
+    parallel_for_blocks(
+        params.num_threads, edges.size(),
+        [&edges, vertex_offset](const uint64_t begin, const uint64_t end) {
+          for (uint64_t i = begin; i < end; ++i) {
+            edges[i] = std::make_pair(vertex_offset + i, vertex_offset + i + 1);
+          }
+        });
+  } else if (params.gen == parameters_t::generator::synthetic) {
+    distributed_synthetic_edge_generator synthetic(
+        world, params.graph, params.graph_scale, synthetic_edge_count(params),
+        trial, params.graph_options);
+
+    edges.resize(synthetic.local_size());
+    parallel_for_blocks(
+        params.num_threads, edges.size(),
+        [&synthetic, &edges](const uint64_t begin, const uint64_t end) {
+          synthetic.generate_batch(
+              begin, std::span<synthetic_edge_generator::edge_type>(
+                         edges.data() + begin, end - begin));
+        });
+  } else if (params.gen == parameters_t::generator::file) {
+    for_all_file_edges(world, edge_list_files(params.input_path),
+                       params.input_format,
+                       [&edges](const uint64_t source, const uint64_t target) {
+                         edges.emplace_back(source, target);
+                       });
   } else {
     world.cerr0() << "Unrecognized graph generator" << std::endl;
     exit(-1);
@@ -119,14 +454,576 @@ std::vector<std::pair<uint64_t, uint64_t>> generate_edges(
   return edges;
 }
 
-void run_cc(ygm::comm                                        &world,
-            const std::vector<std::pair<uint64_t, uint64_t>> &edges,
-            ygm::container::disjoint_set<uint64_t>           &dset) {
+// Calls fn on the same edges generate_edges() returns, without storing them
+template <typename Function>
+void for_all_edges(ygm::comm &world, const parameters_t &params,
+                   const int trial, Function fn) {
+  uint64_t num_vertices = ((uint64_t)1) << params.graph_scale;
+
+  if (params.gen == parameters_t::generator::rmat) {
+    auto rmat = make_rmat_generator(world, params, trial);
+
+    rmat.for_all(fn);
+  } else if (params.gen == parameters_t::generator::linked_list) {
+    auto [vertex_offset, num_local_sources] =
+        linked_list_sources(world, num_vertices);
+
+    for (uint64_t i = 0; i < num_local_sources; ++i) {
+      fn(vertex_offset + i, vertex_offset + i + 1);
+    }
+  } else if (params.gen == parameters_t::generator::synthetic) {
+    distributed_synthetic_edge_generator synthetic(
+        world, params.graph, params.graph_scale, synthetic_edge_count(params),
+        trial, params.graph_options);
+
+    synthetic.for_all(fn);
+  } else if (params.gen == parameters_t::generator::file) {
+    for_all_file_edges(world, edge_list_files(params.input_path),
+                       params.input_format, fn);
+  } else {
+    world.cerr0() << "Unrecognized graph generator" << std::endl;
+    exit(-1);
+  }
+}
+
+// Identifies everything that determines the edges generated for a trial other
+// than the number of ranks
+std::string edge_cache_key(const parameters_t &params, const int trial) {
+  std::string key = "cc";
+  if (params.gen == parameters_t::generator::rmat) {
+    key += "_rmat_g" + std::to_string(params.graph_scale) + "_e" +
+           std::to_string(params.edgefactor) + "_seed" +
+           std::to_string(trial) + "_" + rmat_parameters_key(params.rmat);
+    if (params.rng == rmat_rng::counter) {
+      key += "_counter";
+    }
+  } else if (params.gen == parameters_t::generator::synthetic) {
+    key += "_" + synthetic_graph_key(params.graph, params.graph_options) +
+           "_g" + std::to_string(params.graph_scale) + "_e" +
+           std::to_string(params.edgefactor) + "_seed" +
+           std::to_string(trial);
+  } else {
+    key += "_linked_list_g" + std::to_string(params.graph_scale);
+  }
+
+  return key;
+}
+
+// Sends an edge to solver, as a union to a disjoint_set
+template <typename Solver>
+void async_add_edge(Solver &solver, const uint64_t first,
+                    const uint64_t second) {
+  if constexpr (requires { solver.async_union(first, second); }) {
+    solver.async_union(first, second);
+  } else {
+    solver.async_add_edge(first, second);
+  }
+}
+
+// Edge counts and phase times of one run of connected components on a rank
+struct cc_run {
+  uint64_t local_edges{0};  // Edges of this rank
+  uint64_t sent_edges{0};   // Edges sent after pre-contraction
+  uint64_t num_batches{0};
+  uint64_t components{0};
+  double   union_time{0.0};  // Includes contract_time
+  double   contract_time{0.0};
+  double   solve_time{0.0};
+  double   label_time{0.0};
+  double   count_time{0.0};
+
+  // Queries between batches with -Q, included in union_time
+  uint64_t            queries{0};
+  uint64_t            same_component{0};
+  double              query_time{0.0};
+  std::vector<double> batch_query_times;
+  latency_histogram   query_latencies;
+  latency_histogram   staleness;
+
+  double cc_time() const {
+    return union_time + solve_time + label_time + count_time;
+  }
+};
+
+// Edges of a spanning forest of edges, found with a serial union-find, which
+// connect the same vertices into the same components.  Self-loops are kept
+// only for vertices of no other edge.
+std::vector<std::pair<uint64_t, uint64_t>> spanning_forest(
+    std::span<const std::pair<uint64_t, uint64_t>> edges) {
+  serial_union_find                          union_find;
+  std::vector<std::pair<uint64_t, uint64_t>> forest;
+
+  for (const auto &[first, second] : edges) {
+    if (first != second && union_find.unite(first, second)) {
+      forest.emplace_back(first, second);
+    }
+  }
+  for (const auto &[first, second] : edges) {
+    if (first == second && !union_find.contains(first)) {
+      union_find.find(first);
+      forest.emplace_back(first, second);
+    }
+  }
+
+  return forest;
+}
+
+// Sends edges to solver, replaced by their spanning forest if contract is set
+template <typename Solver>
+void send_edges(std::span<const std::pair<uint64_t, uint64_t>> edges,
+                Solver &solver, const bool contract, cc_run &run) {
+  std::vector<std::pair<uint64_t, uint64_t>> forest;
+
+  run.local_edges += edges.size();
+  if (contract) {
+    ygm::utility::timer contract_timer{};
+    forest = spanning_forest(edges);
+    edges  = forest;
+    run.contract_time += contract_timer.elapsed();
+  }
+
   for (const auto &edge : edges) {
-    dset.async_union(edge.first, edge.second);
+    async_add_edge(solver, edge.first, edge.second);
+  }
+  run.sent_edges += edges.size();
+}
+
+// Vertex and label pairs of the vertices of solver owned by this rank, where
+// each component is labeled by its representative vertex
+template <typename Solver>
+std::vector<std::pair<uint64_t, uint64_t>> extract_labels(ygm::comm &world,
+                                                          Solver    &solver) {
+  std::vector<std::pair<uint64_t, uint64_t>> labels;
+
+  solver.for_all([&labels](const uint64_t vertex, const uint64_t label) {
+    labels.emplace_back(vertex, label);
+  });
+
+  world.barrier();
+
+  return labels;
+}
+
+// Number of components, one per vertex that is its own label
+uint64_t count_components(
+    ygm::comm &world, std::span<const std::pair<uint64_t, uint64_t>> labels) {
+  uint64_t local_roots{0};
+  for (const auto &[vertex, label] : labels) {
+    local_roots += vertex == label;
+  }
+
+  return ygm::sum(local_roots, world);
+}
+
+// Number of components among the vertices of the graph's edges.  A linked
+// list is a single component.  Other graphs are gathered to rank 0 and solved
+// with a serial union-find, so this is only practical at small scales.
+uint64_t expected_components(
+    ygm::comm &world, const parameters_t &params, const int trial,
+    std::span<const std::pair<uint64_t, uint64_t>> edges) {
+  if (params.gen == parameters_t::generator::linked_list) {
+    return params.graph_scale > 0 ? 1 : 0;
+  }
+
+  std::vector<std::pair<uint64_t, uint64_t>> streamed_edges;
+  if (params.stream) {
+    for_all_edges(world, params, trial,
+                  [&streamed_edges](const auto first, const auto second) {
+                    streamed_edges.emplace_back(first, second);
+                  });
+    edges = streamed_edges;
+  }
+
+  MPI_Comm comm       = world.get_mpi_comm();
+  int      send_count = 2 * edges.size();
+  if (2 * edges.size() > std::numeric_limits<int>::max()) {
+    std::cerr << "Too many edges to verify on rank 0" << std::endl;
+    exit(-1);
+  }
+
+  std::vector<int> recv_counts(world.size());
+  MPI_Gather(&send_count, 1, MPI_INT, recv_counts.data(), 1, MPI_INT, 0,
+             comm);
+
+  std::vector<int> recv_displs(world.size(), 0);
+  uint64_t         total_recv = recv_counts[0];
+  for (int rank = 1; rank < world.size(); ++rank) {
+    recv_displs[rank] = recv_displs[rank - 1] + recv_counts[rank - 1];
+    total_recv += recv_counts[rank];
+  }
+  if (world.rank0() && total_recv > std::numeric_limits<int>::max()) {
+    std::cerr << "Too many edges to verify on rank 0" << std::endl;
+    exit(-1);
+  }
+
+  std::vector<std::pair<uint64_t, uint64_t>> all_edges(
+      world.rank0() ? total_recv / 2 : 0);
+  MPI_Gatherv(edges.data(), send_count, MPI_UINT64_T, all_edges.data(),
+              recv_counts.data(), recv_displs.data(), MPI_UINT64_T, 0, comm);
+
+  uint64_t num_components{0};
+  if (world.rank0()) {
+    serial_union_find union_find;
+    for (const auto &[first, second] : all_edges) {
+      union_find.unite(first, second);
+    }
+    num_components = union_find.num_sets();
+  }
+  MPI_Bcast(&num_components, 1, MPI_UINT64_T, 0, comm);
+
+  return num_components;
+}
+
+// Largest and mean number of edges received by a rank of solver.  A union is
+// first sent to the owner of its first vertex; the algorithms of
+// distributed_cc.hpp send edges to the owners of both vertices.
+template <typename Solver>
+std::pair<uint64_t, double> union_receive_load(
+    ygm::comm &world, const parameters_t &params, const int trial,
+    std::span<const std::pair<uint64_t, uint64_t>> edges,
+    const Solver                                  &solver) {
+  std::vector<uint64_t> sent_to_rank(world.size());
+  auto count_union = [&sent_to_rank, &solver](const uint64_t first,
+                                              const uint64_t second) {
+    ++sent_to_rank[container_owner(solver, first)];
+    if constexpr (!requires { solver.async_union(first, second); }) {
+      if (first != second) {
+        ++sent_to_rank[container_owner(solver, second)];
+      }
+    }
+  };
+
+  if (params.stream) {
+    for_all_edges(world, params, trial, count_union);
+  } else {
+    for (const auto &edge : edges) {
+      count_union(edge.first, edge.second);
+    }
+  }
+
+  return receive_load(world, sent_to_rank);
+}
+
+// Collectively asks whether params.queries random pairs of this rank's batch
+// endpoints are in the same component once the batch's unions have
+// completed.  Each rank's queries are made one at a time, with one all_find()
+// per query on every rank, so each query's latency can be timed.  The answers
+// are stale by the time since the batch arrived at batch_start_ns.
+template <typename Solver>
+void run_queries(ygm::comm &world, const parameters_t &params, Solver &solver,
+                 std::span<const std::pair<uint64_t, uint64_t>> batch,
+                 const int64_t batch_start_ns, std::mt19937_64 &gen,
+                 cc_run &run) {
+  std::uniform_int_distribution<uint64_t> dist(
+      0, batch.empty() ? 0 : 2 * batch.size() - 1);
+  auto sample_endpoint = [&batch, &dist, &gen]() {
+    uint64_t endpoint = dist(gen);
+    return endpoint % 2 ? batch[endpoint / 2].second
+                        : batch[endpoint / 2].first;
+  };
+
+  int64_t batch_query_start = steady_clock_ns();
+  int64_t query_end         = batch_query_start;
+  for (int64_t q = 0; q < params.queries; ++q) {
+    std::vector<uint64_t> endpoints;
+    if (!batch.empty()) {
+      endpoints.push_back(sample_endpoint());
+      endpoints.push_back(sample_endpoint());
+    }
+
+    int64_t query_start = steady_clock_ns();
+    auto    labels      = solver.all_find(endpoints);
+    query_end           = steady_clock_ns();
+
+    if (!endpoints.empty()) {
+      run.same_component += labels.at(endpoints[0]) == labels.at(endpoints[1]);
+      run.query_latencies.add(query_end - query_start);
+      ++run.queries;
+    }
+  }
+
+  run.query_time += (query_end - batch_query_start) / 1e9;
+  run.batch_query_times.push_back((query_end - batch_query_start) / 1e9);
+  if (!batch.empty()) {
+    run.staleness.add(query_end - batch_start_ns);
+  }
+}
+
+// Generates edges and sends them immediately, a batch at a time with -b and
+// with a barrier after each batch with -q.  Batches are contracted separately
+// if contract is set, and followed by queries with -Q.
+template <typename Solver>
+void stream_cc(ygm::comm &world, const parameters_t &params, const int trial,
+               Solver &solver, const bool contract, cc_run &run) {
+  using edge_type = std::pair<uint64_t, uint64_t>;
+
+  std::mt19937_64 gen(trial * world.size() + world.rank());
+
+  if (params.batch_size == 0) {
+    for_all_edges(world, params, trial,
+                  [&solver, &run](const auto first, const auto second) {
+                    async_add_edge(solver, first, second);
+                    ++run.local_edges;
+                    ++run.sent_edges;
+                  });
+  } else {
+    run.num_batches = for_all_batches<edge_type>(
+        world, params.batch_size, params.batch_barrier,
+        [&world, &params, trial](auto fn) {
+          for_all_edges(world, params, trial,
+                        [&fn](const auto first, const auto second) {
+                          fn(edge_type(first, second));
+                        });
+        },
+        [&world, &params, &solver, contract, &gen,
+         &run](std::span<const edge_type> batch) {
+          int64_t batch_start = steady_clock_ns();
+          send_edges(batch, solver, contract, run);
+          if (params.batch_barrier) {
+            world.barrier();
+          }
+          if constexpr (requires { solver.all_find({}); }) {
+            if (params.queries > 0) {
+              run_queries(world, params, solver, batch, batch_start, gen, run);
+            }
+          }
+        });
   }
+}
+
+// Sends the trial's edges to solver, contracted if contract is set, and runs
+// the phases that turn solver into a solution: compressing every path of a
+// disjoint_set or running the other algorithms, extracting each vertex's
+// label and counting the components
+template <typename Solver>
+cc_run run_pipeline(ygm::comm &world, const parameters_t &params,
+                    const int                                      trial,
+                    std::span<const std::pair<uint64_t, uint64_t>> input,
+                    Solver &solver, const bool contract) {
+  cc_run run;
 
+  ygm::utility::timer union_timer{};
+  if (params.stream) {
+    stream_cc(world, params, trial, solver, contract, run);
+  } else {
+    send_edges(input, solver, contract, run);
+  }
   world.barrier();
+  run.union_time = union_timer.elapsed();
+
+  ygm::utility::timer solve_timer{};
+  if constexpr (requires { solver.all_compress(); }) {
+    solver.all_compress();
+    world.barrier();
+  } else {
+    solver.run();
+  }
+  run.solve_time = solve_timer.elapsed();
+
+  ygm::utility::timer label_timer{};
+  auto                labels = extract_labels(world, solver);
+  run.label_time             = label_timer.elapsed();
+
+  ygm::utility::timer count_timer{};
+  run.components = count_components(world, labels);
+  run.count_time = count_timer.elapsed();
+
+  return run;
+}
+
+// Runs all trials with Solver, which is ygm's disjoint_set or one of the
+// algorithms of distributed_cc.hpp
+template <typename Solver>
+void run_trials(ygm::comm &world, const parameters_t &params,
+                const uint64_t input_bytes, memory_profile &memory,
+                boost::json::object &output) {
+  for (int trial = 0; trial < params.num_trials; ++trial) {
+    Solver solver(world);
+    world.stats_reset();
+
+    reset_peak_rss();
+    memory.record("CONTAINER_INIT");
+
+    std::vector<std::pair<uint64_t, uint64_t>>          edges;
+    mapped_binary_array<std::pair<uint64_t, uint64_t>> cached_edges;
+    double                                             generation_time{0.0};
+    double                                             load_time{0.0};
+    double                                             load_rate{0.0};
+    double                                             write_time{0.0};
+    bool                                               cache_hit{false};
+    if (!params.stream) {
+      std::string cache_path;
+      if (!params.cache_dir.empty()) {
+        cache_path = binary_array_cache_path(world, params.cache_dir,
+                                             edge_cache_key(params, trial));
+
+        world.barrier();
+        ygm::utility::timer load_timer{};
+
+        cache_hit = open_binary_array_cache(world, cache_path, cached_edges);
+
+        if (cache_hit) {
+          load_time = load_timer.elapsed();
+          load_rate = ygm::sum(cached_edges.size_bytes(), world) /
+                      load_time / (1000 * 1000 * 1000);
+        }
+      }
+
+      if (!cache_hit) {
+        ygm::utility::timer generation_timer{};
+
+        edges = generate_edges(world, params, trial);
+
+        generation_time = generation_timer.elapsed();
+
+        if (!cache_path.empty()) {
+          ygm::utility::timer write_timer{};
+
+          bool written = ygm::logical_and(
+              write_binary_array(
+                  cache_path,
+                  std::span<const std::pair<uint64_t, uint64_t>>(edges)),
+              world);
+
+          write_time = write_timer.elapsed();
+          if (!written) {
+            world.cerr0() << "Failed to write edge cache to "
+                          << params.cache_dir << std::endl;
+          }
+        }
+      }
+
+      memory.record("INPUT_GENERATED");
+    }
+
+    std::span<const std::pair<uint64_t, uint64_t>> input(edges);
+    if (cache_hit) {
+      input = cached_edges.data();
+    }
+
+    // The same run without pre-contraction, for the speedup of -c
+    cc_run baseline;
+    if (params.precontract) {
+      Solver baseline_solver(world);
+      baseline =
+          run_pipeline(world, params, trial, input, baseline_solver, false);
+      world.stats_reset();
+      reset_peak_rss();
+    }
+
+    memory.start_sampling();
+    world.barrier();
+
+    cc_run run = run_pipeline(world, params, trial, input, solver,
+                              params.precontract);
+    memory.record("KERNEL");
+
+    double   trial_time     = run.union_time;
+    double   cc_time        = run.cc_time();
+    uint64_t num_components = run.components;
+    uint64_t num_edges      = ygm::sum(run.local_edges, world);
+    double   trial_rate     = num_edges / trial_time / (1000 * 1000);
+
+    if (params.verify) {
+      ygm::utility::timer verify_timer{};
+      uint64_t            expected =
+          expected_components(world, params, trial, input);
+
+      output["EXPECTED_COMPONENTS"].as_array().emplace_back(expected);
+      output["VERIFIED"].as_array().emplace_back(expected == num_components);
+      output["VERIFY_TIME"].as_array().emplace_back(verify_timer.elapsed());
+      if (expected != num_components) {
+        world.cerr0() << "Verification failed in trial " << trial << ": "
+                      << num_components << " components, expected "
+                      << expected << std::endl;
+      }
+    }
+
+    auto [max_receive_load, mean_receive_load] =
+        union_receive_load(world, params, trial, input, solver);
+
+    output["TIME"].as_array().emplace_back(trial_time);
+    output["UNIONS_PER_SECOND(MILLIONS)"].as_array().emplace_back(trial_rate);
+    output["SOLVE_TIME"].as_array().emplace_back(run.solve_time);
+    output["LABEL_TIME"].as_array().emplace_back(run.label_time);
+    output["COUNT_TIME"].as_array().emplace_back(run.count_time);
+    output["CC_TIME"].as_array().emplace_back(cc_time);
+    output["COMPONENTS"].as_array().emplace_back(num_components);
+    output["GENERATION_TIME"].as_array().emplace_back(generation_time);
+    output["TIME_TO_SOLUTION"].as_array().emplace_back(
+        generation_time + load_time + cc_time);
+    output["PEAK_RSS_KB"].as_array().emplace_back(
+        ygm::max(read_proc_status_kb("VmHWM"), world));
+    output["MAX_RANK_RECEIVE_LOAD"].as_array().emplace_back(max_receive_load);
+    output["RECEIVE_LOAD_IMBALANCE"].as_array().emplace_back(
+        max_receive_load / mean_receive_load);
+    output["EDGES"] = num_edges;
+    if (params.batch_size > 0) {
+      output["NUM_BATCHES"].as_array().emplace_back(
+          ygm::max(run.num_batches, world));
+    }
+    if (params.precontract) {
+      uint64_t eliminated = num_edges - ygm::sum(run.sent_edges, world);
+
+      output["CONTRACTION_TIME"].as_array().emplace_back(
+          ygm::max(run.contract_time, world));
+      output["EDGES_ELIMINATED"].as_array().emplace_back(eliminated);
+      output["ELIMINATED_FRACTION"].as_array().emplace_back(
+          num_edges > 0 ? double(eliminated) / num_edges : 0.0);
+      output["BASELINE_CC_TIME"].as_array().emplace_back(baseline.cc_time());
+      output["SPEEDUP"].as_array().emplace_back(baseline.cc_time() / cc_time);
+    }
+    if (params.queries > 0) {
+      uint64_t num_queries = ygm::sum(run.queries, world);
+      double   query_time  = ygm::max(run.query_time, world);
+
+      // Every rank makes one all_find() per batch
+      boost::json::array batch_query_times;
+      for (const double time : run.batch_query_times) {
+        batch_query_times.emplace_back(ygm::max(time, world));
+      }
+
+      run.query_latencies.merge(world.get_mpi_comm());
+      run.staleness.merge(world.get_mpi_comm());
+
+      output["QUERIES"].as_array().emplace_back(num_queries);
+      output["SAME_COMPONENT_FRACTION"].as_array().emplace_back(
+          num_queries > 0
+              ? double(ygm::sum(run.same_component, world)) / num_queries
+              : 0.0);
+      output["QUERY_TIME"].as_array().emplace_back(query_time);
+      output["BATCH_QUERY_TIME"].as_array().emplace_back(batch_query_times);
+      output["UPDATE_EDGES_PER_SECOND(MILLIONS)"].as_array().emplace_back(
+          num_edges / (trial_time - query_time) / (1000 * 1000));
+      for (const auto &[suffix, q] : latency_percentiles) {
+        output["QUERY_LATENCY_" + suffix + "_NS"].as_array().emplace_back(
+            run.query_latencies.percentile(q));
+        output["STALENESS_" + suffix + "_NS"].as_array().emplace_back(
+            run.staleness.percentile(q));
+      }
+    }
+    if constexpr (requires { solver.iterations(); }) {
+      output["ITERATIONS"].as_array().emplace_back(solver.iterations());
+    }
+    if constexpr (requires { solver.label_updates(); }) {
+      output["LABEL_UPDATES"].as_array().emplace_back(
+          ygm::sum(solver.label_updates(), world));
+    }
+    if (params.gen == parameters_t::generator::file && !params.stream) {
+      output["INGEST_EDGES_PER_SECOND(MILLIONS)"].as_array().emplace_back(
+          num_edges / generation_time / (1000 * 1000));
+      output["INGEST_MB_PER_SECOND"].as_array().emplace_back(
+          input_bytes / generation_time / (1000 * 1000));
+    }
+    if (!params.cache_dir.empty()) {
+      output["CACHE_HIT"].as_array().emplace_back(cache_hit);
+      output["CACHE_LOAD_TIME"].as_array().emplace_back(load_time);
+      output["CACHE_LOAD_GB_PER_SECOND"].as_array().emplace_back(load_rate);
+      output["CACHE_WRITE_TIME"].as_array().emplace_back(write_time);
+    }
+
+    parse_stats(world, output);
+  }
 }
 
 int main(int argc, char **argv) {
@@ -136,57 +1033,140 @@ int main(int argc, char **argv) {
     parameters_t params = parse_cmd_line(argc, argv, world);
 
     uint64_t num_vertices = ((uint64_t)1) << params.graph_scale;
+    uint64_t input_bytes{0};
 
     boost::json::object output;
 
     output["NAME"]                        = "CC_YGM";
     output["TIME"]                        = boost::json::array();
     output["UNIONS_PER_SECOND(MILLIONS)"] = boost::json::array();
+    output["SOLVE_TIME"]                  = boost::json::array();
+    output["LABEL_TIME"]                  = boost::json::array();
+    output["COUNT_TIME"]                  = boost::json::array();
+    output["CC_TIME"]                     = boost::json::array();
+    output["COMPONENTS"]                  = boost::json::array();
+    output["GENERATION_TIME"]             = boost::json::array();
+    output["TIME_TO_SOLUTION"]            = boost::json::array();
+    output["PEAK_RSS_KB"]                 = boost::json::array();
+    output["MAX_RANK_RECEIVE_LOAD"]       = boost::json::array();
+    output["RECEIVE_LOAD_IMBALANCE"]      = boost::json::array();
     output["GLOBAL_ASYNC_COUNT"]          = boost::json::array();
     output["GLOBAL_ISEND_COUNT"]          = boost::json::array();
     output["GLOBAL_ISEND_BYTES"]          = boost::json::array();
     output["MAX_WAITSOME_ISEND_IRECV"]    = boost::json::array();
     output["MAX_WAITSOME_IALLREDUCE"]     = boost::json::array();
     output["COUNT_IALLREDUCE"]            = boost::json::array();
-    output["GRAPH_SCALE"]                 = params.graph_scale;
-    output["VERTICES"]                    = num_vertices;
+    output["RANK_INVARIANT"]              = params.rng == rmat_rng::counter;
+    output["GENERATION_THREADS"]          = params.num_threads;
+    output["STREAM"]                      = params.stream;
+    output["VERIFY"]                      = params.verify;
+    output["PRECONTRACT"]                 = params.precontract;
+    if (params.precontract) {
+      output["CONTRACTION_TIME"]    = boost::json::array();
+      output["EDGES_ELIMINATED"]    = boost::json::array();
+      output["ELIMINATED_FRACTION"] = boost::json::array();
+      output["BASELINE_CC_TIME"]    = boost::json::array();
+      output["SPEEDUP"]             = boost::json::array();
+    }
+    if (params.algorithm == parameters_t::algorithm_type::fastsv) {
+      output["ALGORITHM"]  = "FASTSV";
+      output["ITERATIONS"] = boost::json::array();
+    } else if (params.algorithm ==
+               parameters_t::algorithm_type::label_propagation) {
+      output["ALGORITHM"]     = "LABEL_PROPAGATION";
+      output["LABEL_UPDATES"] = boost::json::array();
+    } else {
+      output["ALGORITHM"] = "DISJOINT_SET";
+    }
+    if (params.verify) {
+      output["EXPECTED_COMPONENTS"] = boost::json::array();
+      output["VERIFIED"]            = boost::json::array();
+      output["VERIFY_TIME"]         = boost::json::array();
+    }
+    if (params.batch_size > 0) {
+      output["BATCH_SIZE"]    = params.batch_size;
+      output["BATCH_BARRIER"] = params.batch_barrier;
+      output["NUM_BATCHES"]   = boost::json::array();
+    }
+    if (params.queries > 0) {
+      output["QUERIES_PER_BATCH"]                 = params.queries;
+      output["QUERIES"]                           = boost::json::array();
+      output["SAME_COMPONENT_FRACTION"]           = boost::json::array();
+      output["QUERY_TIME"]                        = boost::json::array();
+      output["BATCH_QUERY_TIME"]                  = boost::json::array();
+      output["UPDATE_EDGES_PER_SECOND(MILLIONS)"] = boost::json::array();
+      for (const auto &[suffix, q] : latency_percentiles) {
+        output["QUERY_LATENCY_" + suffix + "_NS"] = boost::json::array();
+        output["STALENESS_" + suffix + "_NS"]     = boost::json::array();
+      }
+    }
+    if (!params.cache_dir.empty()) {
+      output["CACHE_DIR"]                = params.cache_dir;
+      output["CACHE_HIT"]                = boost::json::array();
+      output["CACHE_LOAD_TIME"]          = boost::json::array();
+      output["CACHE_LOAD_GB_PER_SECOND"] = boost::json::array();
+      output["CACHE_WRITE_TIME"]         = boost::json::array();
+    }
     if (params.gen == parameters_t::generator::rmat) {
-      output["GENERATOR"] = "RMAT";
+      output["GENERATOR"]       = "RMAT";
+      output["GRAPH_SCALE"]     = params.graph_scale;
+      output["VERTICES"]        = num_vertices;
+      output["RMAT_A"]          = params.rmat.a;
+      output["RMAT_B"]          = params.rmat.b;
+      output["RMAT_C"]          = params.rmat.c;
+      output["RMAT_D"]          = params.rmat.d;
+      output["RMAT_SCRAMBLER"]  = rmat_scrambler_name(params.rmat);
+      output["RMAT_UNDIRECTED"] = params.rmat.undirected;
     } else if (params.gen == parameters_t::generator::linked_list) {
-      output["GENERATOR"] = "LINKED_LIST";
+      output["GENERATOR"]   = "LINKED_LIST";
+      output["GRAPH_SCALE"] = params.graph_scale;
+      output["VERTICES"]    = num_vertices;
+    } else if (params.gen == parameters_t::generator::synthetic) {
+      output["GENERATOR"]   = synthetic_graph_name(params.graph);
+      output["GRAPH_SCALE"] = params.graph_scale;
+      output["VERTICES"]    = num_vertices;
+      if (params.graph == synthetic_graph::zipf) {
+        output["ZIPF_EXPONENT"] = params.graph_options.zipf_exponent;
+      } else if (params.graph == synthetic_graph::chung_lu) {
+        output["POWER_LAW_EXPONENT"] = params.graph_options.power_law_exponent;
+      } else if (params.graph == synthetic_graph::block_local) {
+        output["LOCAL_FRACTION"] = params.graph_options.local_fraction;
+      }
+    } else if (params.gen == parameters_t::generator::file) {
+      input_bytes = edge_list_bytes(edge_list_files(params.input_path));
+
+      output["GENERATOR"]   = "FILE";
+      output["INPUT_PATH"]  = params.input_path;
+      output["INPUT_BYTES"] = input_bytes;
+      if (params.input_format == edge_list_format::binary) {
+        output["INPUT_FORMAT"] = "BINARY";
+      } else {
+        output["INPUT_FORMAT"] = "TEXT";
+      }
+      output["INGEST_EDGES_PER_SECOND(MILLIONS)"] = boost::json::array();
+      output["INGEST_MB_PER_SECOND"]              = boost::json::array();
     } else {
       output["GENERATOR"] = "UNKNOWN";
     }
 
     parse_welcome(world, output);
 
-    for (int trial = 0; trial < params.num_trials; ++trial) {
-      ygm::container::disjoint_set<uint64_t> dset(world);
-      world.stats_reset();
-
-      std::vector<std::pair<uint64_t, uint64_t>> edges = generate_edges(
-          world, params.graph_scale, params.edgefactor, trial, params.gen);
-
-      uint64_t num_edges = ygm::sum(edges.size(), world);
-
-      double trial_time;
-      double trial_rate;
-      world.barrier();
+    memory_profile memory(world.get_mpi_comm(), output);
+    memory.record("STARTUP");
 
-      ygm::utility::timer update_timer{};
-
-      run_cc(world, edges, dset);
-
-      trial_time = update_timer.elapsed();
-      trial_rate = num_edges / trial_time / (1000 * 1000);
-
-      output["TIME"].as_array().emplace_back(trial_time);
-      output["UNIONS_PER_SECOND(MILLIONS)"].as_array().emplace_back(trial_rate);
-      output["EDGES"] = num_edges;
-
-      parse_stats(world, output);
+    if (params.algorithm == parameters_t::algorithm_type::fastsv) {
+      run_trials<fastsv_cc>(world, params, input_bytes, memory, output);
+    } else if (params.algorithm ==
+               parameters_t::algorithm_type::label_propagation) {
+      run_trials<label_propagation_cc>(world, params, input_bytes, memory,
+                                       output);
+    } else {
+      run_trials<ygm::container::disjoint_set<uint64_t>>(
+          world, params, input_bytes, memory, output);
     }
 
+    memory.record("TEARDOWN");
+
     if (params.pretty_print) {
       pretty_print(world.cout0(), output);
       world.cout0() << "\n";
@@ -16,6 +16,16 @@ std::uint32_t make_seed(const std::uint32_t seed, int size, const int rank,
   return seed + size * trial + rank;
 }
 
+rmat_edge_generator make_rmat_generator(const parameters_t &params,
+                                        const std::uint32_t seed) {
+  const rmat_parameters &rmat = params.rmat_params;
+
+  return rmat_edge_generator(params.log_vertex_count, params.local_edge_count,
+                             seed, rmat.scramble, rmat.undirected, rmat.a,
+                             rmat.b, rmat.c, rmat.d, rmat_rng::sequential,
+                             rmat.scrambler);
+}
+
 struct uniform_edge_vec_generator_t {
   uniform_edge_vec_generator_t(ygm::comm &world, const parameters_t &params,
                                const int trial)
@@ -52,10 +62,15 @@ struct rmat_edge_vec_generator_t {
         _local_edge_count(params.local_edge_count) {
     std::uint32_t seed(
         make_seed(params.seed, world.size(), world.rank(), trial));
-    rmat_edge_generator rmat(params.log_vertex_count, params.local_edge_count,
-                             seed);
+    rmat_edge_generator rmat = make_rmat_generator(params, seed);
+    // Undirected graphs insert each generated edge in both directions while
+    // keeping the number of insertions fixed
     for (int i(0); i < _local_edge_count; ++i) {
-      _edges[i] = rmat.generate_single_edge();
+      if (params.rmat_params.undirected && i % 2 == 1) {
+        _edges[i] = {_edges[i - 1].second, _edges[i - 1].first};
+      } else {
+        _edges[i] = rmat.generate_single_edge();
+      }
     }
   }
 
@@ -92,15 +107,26 @@ struct rmat_edge_stream_generator_t {
   rmat_edge_stream_generator_t(ygm::comm &world, const parameters_t &params,
                                const int trial)
       : _seed(make_seed(params.seed, world.size(), world.rank(), trial)),
-        _rmat(params.log_vertex_count, params.local_edge_count, _seed) {}
+        _rmat(make_rmat_generator(params, _seed)),
+        _undirected(params.rmat_params.undirected),
+        _reverse_next(false) {}
 
   std::pair<std::uint64_t, std::uint64_t> operator()() {
-    return _rmat.generate_single_edge();
+    if (_reverse_next) {
+      _reverse_next = false;
+      return {_last_edge.second, _last_edge.first};
+    }
+    _last_edge    = _rmat.generate_single_edge();
+    _reverse_next = _undirected;
+    return _last_edge;
   }
 
  private:
-  rmat_edge_generator _rmat;
-  std::uint32_t       _seed;
+  std::uint32_t                           _seed;
+  rmat_edge_generator                     _rmat;
+  bool                                    _undirected;
+  bool                                    _reverse_next;
+  std::pair<std::uint64_t, std::uint64_t> _last_edge;
 };
 
 int main(int argc, char **argv) {
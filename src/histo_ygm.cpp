@@ -3,13 +3,21 @@
 //
 // SPDX-License-Identifier: MIT
 
+#include <binary_array_file.hpp>
+#include <bulk_histogram.hpp>
+#include <counter_random_stream.hpp>
+#include <hot_keys.hpp>
+#include <local_combiner.hpp>
+#include <memory_profile.hpp>
 #include <random>
+#include <unordered_set>
 #include <rmat_edge_generator.hpp>
+#include <synthetic_edge_generator.hpp>
 #include <utility.hpp>
 #include <ygm/comm.hpp>
 #include <ygm/container/array.hpp>
+#include <ygm/container/counting_set.hpp>
 #include <ygm/container/detail/base_async_reduce.hpp>
-#include <ygm/container/detail/reducing_adapter.hpp>
 #include <ygm/container/map.hpp>
 #include <ygm/detail/ygm_cereal_archive.hpp>
 #include <ygm/utility/timer.hpp>
@@ -17,21 +25,53 @@
 #include <boost/json/src.hpp>
 
 struct parameters_t {
-  enum class distribution { uniform, rmat };
+  enum class distribution { uniform, rmat, synthetic };
+  enum class container { array, map, counting_set };
 
-  int          log_table_size;
-  int64_t      local_updates;
-  int          num_trials;
-  distribution dist;
-  bool         use_reducing_adapter;
-  bool         pretty_print;
+  int                     log_table_size;
+  int64_t                 local_updates;
+  int64_t                 global_updates;
+  uint64_t                first_update;
+  bool                    global_count;
+  int                     num_trials;
+  distribution            dist;
+  container               cont;
+  synthetic_graph         graph;
+  synthetic_graph_options graph_options;
+  rmat_parameters         rmat;
+  rmat_rng                rng;
+  int                     num_threads;
+  bool                    stream;
+  uint64_t                batch_size;
+  bool                    batch_barrier;
+  std::string             cache_dir;
+  bool                    use_reducing_adapter;
+  bool                    bulk;
+  uint64_t                num_hot_keys;
+  uint64_t                combiner_capacity;
+  int                     word_bits;
+  bool                    pretty_print;
 
   parameters_t()
       : log_table_size(15),
         local_updates(1024 * 1024),
+        global_updates(0),
+        first_update(0),
+        global_count(false),
         num_trials(5),
         dist(distribution::uniform),
+        cont(container::map),
+        graph(synthetic_graph::erdos_renyi),
+        rng(rmat_rng::sequential),
+        num_threads(1),
+        stream(false),
+        batch_size(0),
+        batch_barrier(false),
         use_reducing_adapter(false),
+        bulk(false),
+        num_hot_keys(0),
+        combiner_capacity(1 << 16),
+        word_bits(0),
         pretty_print(false) {}
 };
 
@@ -40,9 +80,49 @@ void usage(ygm::comm &comm) {
       << "histo_ygm usage:"
       << "\n\t-s <int>\t- Log_2 of global table size"
       << "\n\t-i <int>\t- Number of insertions per rank"
+      << "\n\t-N <int>\t- Number of insertions across all ranks, split "
+         "evenly (overrides -i; with -I, the insertions are identical for "
+         "any number of ranks)"
       << "\n\t-t <int>\t- Number of trials"
       << "\n\t-r\t\t- Flag indicating insertions should use RMAT generator"
-      << "\n\t-a\t\t- Flag indicating use of reducing_adapter"
+      << "\n\t-R <str>\t- RMAT quadrant probabilities a,b,c,d (default "
+         "0.57,0.19,0.19,0.05)"
+      << "\n\t-S <str>\t- RMAT vertex scrambler (none, hash, feistel)"
+      << "\n\t-U\t\t- Flag indicating RMAT edges should be undirected "
+         "(both orientations inserted)"
+      << "\n\t-d <str>\t- Insertion distribution (uniform, rmat, er, zipf, "
+         "chung_lu, grid2d, grid3d, torus2d, torus3d, block_local); "
+         "insertions are edge endpoints for graphs"
+      << "\n\t-z <float>\t- Zipf exponent of zipf insertions"
+      << "\n\t-G <float>\t- Power-law degree exponent of chung_lu "
+         "insertions"
+      << "\n\t-L <float>\t- Fraction of block_local insertions owned by "
+         "the inserting rank (requires -c array or -B)"
+      << "\n\t-I\t\t- Flag indicating insertions should be identical for "
+         "any number of ranks (given -N) and threads"
+      << "\n\t-T <int>\t- Number of threads generating insertions per rank "
+         "(implies -I when above 1)"
+      << "\n\t-m\t\t- Flag indicating streaming mode (insertions are sent "
+         "as they are generated)"
+      << "\n\t-b <int>\t- Number of insertions per rank generated and sent "
+         "as one batch (implies -m; default 0, unbatched)"
+      << "\n\t-q\t\t- Flag indicating a barrier should follow each batch "
+         "of -b, bounding the insertions in flight"
+      << "\n\t-C <str>\t- Directory for caching generated insertions across "
+         "trials and runs"
+      << "\n\t-c <str>\t- Histogram container (array, map, counting_set; "
+         "default map)"
+      << "\n\t-B\t\t- Flag indicating a bulk-synchronous histogram "
+         "(sort, combine and MPI_Alltoallv) should replace the container"
+      << "\n\t-H <int>\t- Number of hot indices, found by sampling, whose "
+         "insertions are accumulated on every rank and merged at the end "
+         "(default 0)"
+      << "\n\t-a\t\t- Flag indicating insertions to the same index should "
+         "be combined before leaving the rank"
+      << "\n\t-K <int>\t- Number of entries in the local combiner cache "
+         "used by -a (default 65536)"
+      << "\n\t-W <int>\t- Bits per sent index and count (32 or 64; "
+         "default is 32 when the table and insertion count fit)"
       << "\n\t-p\t\t- Pretty print output"
       << "\n\t-h\t\t- Print help" << std::endl;
 }
@@ -56,7 +136,8 @@ parameters_t parse_cmd_line(int argc, char **argv, ygm::comm &comm) {
   extern int opterr;
   opterr = 0;
 
-  while ((c = getopt(argc, argv, "s:i:t:raph")) != -1) {
+  while ((c = getopt(argc, argv,
+                      "s:i:N:t:rR:S:Ud:z:G:L:IT:mb:qC:c:BH:aK:W:ph")) != -1) {
     switch (c) {
       case 'h':
         prn_help = true;
@@ -67,15 +148,99 @@ parameters_t parse_cmd_line(int argc, char **argv, ygm::comm &comm) {
       case 'i':
         params.local_updates = atoll(optarg);
         break;
+      case 'N':
+        params.global_updates = atoll(optarg);
+        params.global_count   = true;
+        break;
       case 't':
         params.num_trials = atoi(optarg);
         break;
       case 'r':
         params.dist = parameters_t::distribution::rmat;
         break;
+      case 'R':
+        if (!parse_rmat_probabilities(optarg, params.rmat)) {
+          comm.cerr0() << "Invalid RMAT probabilities: " << optarg
+                       << std::endl;
+          prn_help = true;
+        }
+        break;
+      case 'S':
+        if (!parse_rmat_scrambler(optarg, params.rmat)) {
+          comm.cerr0() << "Unrecognized scrambler: " << optarg << std::endl;
+          prn_help = true;
+        }
+        break;
+      case 'U':
+        params.rmat.undirected = true;
+        break;
+      case 'd':
+        if (std::string(optarg) == "uniform") {
+          params.dist = parameters_t::distribution::uniform;
+        } else if (std::string(optarg) == "rmat") {
+          params.dist = parameters_t::distribution::rmat;
+        } else if (parse_synthetic_graph(optarg, params.graph)) {
+          params.dist = parameters_t::distribution::synthetic;
+        } else {
+          comm.cerr0() << "Unrecognized distribution: " << optarg
+                       << std::endl;
+          prn_help = true;
+        }
+        break;
+      case 'z':
+        params.graph_options.zipf_exponent = atof(optarg);
+        break;
+      case 'G':
+        params.graph_options.power_law_exponent = atof(optarg);
+        break;
+      case 'L':
+        params.graph_options.local_fraction = atof(optarg);
+        break;
+      case 'I':
+        params.rng = rmat_rng::counter;
+        break;
+      case 'T':
+        params.num_threads = atoi(optarg);
+        break;
+      case 'm':
+        params.stream = true;
+        break;
+      case 'b':
+        params.batch_size = atoll(optarg);
+        break;
+      case 'q':
+        params.batch_barrier = true;
+        break;
+      case 'C':
+        params.cache_dir = optarg;
+        break;
+      case 'c':
+        if (std::string(optarg) == "array") {
+          params.cont = parameters_t::container::array;
+        } else if (std::string(optarg) == "map") {
+          params.cont = parameters_t::container::map;
+        } else if (std::string(optarg) == "counting_set") {
+          params.cont = parameters_t::container::counting_set;
+        } else {
+          comm.cerr0() << "Unrecognized container: " << optarg << std::endl;
+          prn_help = true;
+        }
+        break;
+      case 'B':
+        params.bulk = true;
+        break;
+      case 'H':
+        params.num_hot_keys = atoll(optarg);
+        break;
       case 'a':
         params.use_reducing_adapter = true;
         break;
+      case 'K':
+        params.combiner_capacity = atoll(optarg);
+        break;
+      case 'W':
+        params.word_bits = atoi(optarg);
+        break;
       case 'p':
         params.pretty_print = true;
         break;
@@ -86,6 +251,141 @@ parameters_t parse_cmd_line(int argc, char **argv, ygm::comm &comm) {
     }
   }
 
+  // A global count is split as evenly as possible, with rank r generating
+  // global insertions [first_update, first_update + local_updates)
+  if (params.global_count) {
+    int64_t min_updates  = params.global_updates / comm.size();
+    int64_t extra        = params.global_updates % comm.size();
+    params.local_updates = min_updates + (comm.rank() < extra);
+    params.first_update =
+        comm.rank() * min_updates + std::min<int64_t>(comm.rank(), extra);
+  } else {
+    params.global_updates = params.local_updates * comm.size();
+    params.first_update   = comm.rank() * params.local_updates;
+  }
+
+  if (params.local_updates < 0 || params.global_updates < 0) {
+    comm.cerr0() << "Insertion counts (-i and -N) must not be negative"
+                 << std::endl;
+    prn_help = true;
+  }
+
+  // Written to reject NaN as well
+  if (!(params.graph_options.power_law_exponent > 1.0)) {
+    comm.cerr0() << "Power-law exponent (-G) must be greater than 1"
+                 << std::endl;
+    prn_help = true;
+  }
+
+  if (!(params.graph_options.local_fraction >= 0.0 &&
+        params.graph_options.local_fraction <= 1.0)) {
+    comm.cerr0() << "Local fraction (-L) must be between 0 and 1" << std::endl;
+    prn_help = true;
+  }
+
+  // block_local locality follows the block partition of arrays and -B; map
+  // and counting_set hash their keys
+  if (params.dist == parameters_t::distribution::synthetic &&
+      params.graph == synthetic_graph::block_local && !params.bulk &&
+      params.cont != parameters_t::container::array) {
+    comm.cerr0() << "block_local insertions require a block-partitioned "
+                    "table (-c array or -B)"
+                 << std::endl;
+    prn_help = true;
+  }
+
+  // Every edge provides 2 insertions, or 4 when undirected
+  uint64_t indices_per_edge =
+      params.dist == parameters_t::distribution::rmat && params.rmat.undirected
+          ? 4
+          : 2;
+  if (params.dist != parameters_t::distribution::uniform &&
+      params.global_updates % indices_per_edge != 0) {
+    comm.cerr0() << "Total insertions (-N, or -i times the number of ranks) "
+                    "of graph distributions must be a multiple of "
+                 << indices_per_edge << std::endl;
+    prn_help = true;
+  }
+
+  if (params.num_threads < 1) {
+    comm.cerr0() << "Number of threads (-T) must be positive" << std::endl;
+    prn_help = true;
+  }
+
+  // Threads generate disjoint ranges of insertions, which requires
+  // counter-based generation
+  if (params.num_threads > 1) {
+    params.rng = rmat_rng::counter;
+  }
+
+  // Batches are generated as they are sent rather than stored
+  if (params.batch_size > 0) {
+    params.stream = true;
+  }
+
+  if (params.batch_barrier && params.batch_size == 0) {
+    comm.cerr0() << "Barriers between batches (-q) require a batch size (-b)"
+                 << std::endl;
+    prn_help = true;
+  }
+
+  if (params.stream && !params.cache_dir.empty()) {
+    comm.cerr0() << "Insertion caching (-C) requires stored insertions and "
+                    "cannot be combined with streaming (-m or -b)"
+                 << std::endl;
+    prn_help = true;
+  }
+
+  if (params.word_bits != 0 && params.word_bits != 32 &&
+      params.word_bits != 64) {
+    comm.cerr0() << "Word size (-W) must be 32 or 64" << std::endl;
+    prn_help = true;
+  }
+
+  if (params.word_bits == 32 &&
+      (params.log_table_size > 32 ||
+       uint64_t(params.global_updates) > UINT32_MAX)) {
+    comm.cerr0() << "32-bit words (-W 32) require at most 2^32 table "
+                    "entries and insertions"
+                 << std::endl;
+    prn_help = true;
+  }
+
+  if (params.bulk && ((params.stream && params.batch_size == 0) ||
+                      params.use_reducing_adapter)) {
+    comm.cerr0() << "Bulk-synchronous mode (-B) exchanges stored insertions "
+                    "or batches (-b) in one step each and cannot be combined "
+                    "with -m or -a"
+                 << std::endl;
+    prn_help = true;
+  }
+
+  if (params.num_hot_keys > 0 &&
+      (params.bulk || params.use_reducing_adapter ||
+       params.cont == parameters_t::container::counting_set)) {
+    comm.cerr0() << "Hot-key replication (-H) sends combined counts and "
+                    "cannot be combined with -B, -a or counting_set"
+                 << std::endl;
+    prn_help = true;
+  }
+
+  // An array or bulk table of 2^32 entries would wrap a 32-bit size to 0
+  if (params.word_bits == 32 && params.log_table_size == 32 &&
+      (params.bulk || params.cont == parameters_t::container::array)) {
+    comm.cerr0() << "32-bit words (-W 32) with arrays and -B require fewer "
+                    "than 2^32 table entries"
+                 << std::endl;
+    prn_help = true;
+  }
+
+  if (params.use_reducing_adapter &&
+      params.cont == parameters_t::container::counting_set) {
+    comm.cerr0() << "counting_set combines insertions itself and cannot be "
+                    "used with -a"
+                 << std::endl;
+    prn_help = true;
+  }
+
   if (prn_help) {
     usage(comm);
     exit(-1);
@@ -94,29 +394,108 @@ parameters_t parse_cmd_line(int argc, char **argv, ygm::comm &comm) {
   return params;
 }
 
-std::vector<uint64_t> generate_indices(ygm::comm     &world,
-                                       const uint64_t local_updates,
-                                       const int      log_table_size,
-                                       const int      trial,
-                                       const parameters_t::distribution dist) {
+// Global insertion i of the uniform distribution with counter-based generation
+inline uint64_t counter_uniform_index(const int trial, const uint64_t i,
+                                      const uint64_t global_table_size) {
+  counter_random_stream stream(trial, i);
+  return stream.next() & (global_table_size - 1);
+}
+
+// Insertions made from the endpoints of a distributed edge generator's local
+// edges.  Edge i of this rank provides indices 2i and 2i+1, followed by 2i+2
+// and 2i+3 for its reverse when undirected, matching the order of for_all().
+template <typename Generator>
+std::vector<uint64_t> generate_edge_indices(Generator &gen,
+                                            const int  num_threads,
+                                            const bool undirected) {
+  const uint64_t        per_edge = undirected ? 4 : 2;
+  std::vector<uint64_t> indices(per_edge * gen.local_size());
+
+  auto generate_edges = [&gen, &indices, per_edge](const uint64_t begin,
+                                                   const uint64_t end) {
+    std::vector<std::pair<uint64_t, uint64_t>> batch(4096);
+    for (uint64_t i = begin; i < end; i += batch.size()) {
+      std::span<std::pair<uint64_t, uint64_t>> edges(
+          batch.data(), std::min<uint64_t>(batch.size(), end - i));
+      if (gen.is_counter_based()) {
+        gen.generate_batch(i, edges);
+      } else {
+        gen.generate_batch(edges);
+      }
+      for (size_t j = 0; j < edges.size(); ++j) {
+        uint64_t *edge_indices = &indices[per_edge * (i + j)];
+        edge_indices[0]        = edges[j].first;
+        edge_indices[1]        = edges[j].second;
+        if (per_edge == 4) {
+          edge_indices[2] = edges[j].second;
+          edge_indices[3] = edges[j].first;
+        }
+      }
+    }
+  };
+
+  if (gen.is_counter_based()) {
+    parallel_for_blocks(num_threads, gen.local_size(), generate_edges);
+  } else {
+    generate_edges(0, gen.local_size());
+  }
+
+  return indices;
+}
+
+// RMAT generator providing global_updates insertions across all ranks
+distributed_rmat_edge_generator make_rmat_generator(ygm::comm          &world,
+                                                    const parameters_t &params,
+                                                    const int           trial) {
+  uint64_t indices_per_edge = params.rmat.undirected ? 4 : 2;
+
+  return distributed_rmat_edge_generator(
+      world, params.log_table_size,
+      params.global_updates / indices_per_edge, trial,
+      params.rmat.scramble, params.rmat.undirected, params.rmat.a,
+      params.rmat.b, params.rmat.c, params.rmat.d, params.rng,
+      params.rmat.scrambler);
+}
+
+std::vector<uint64_t> generate_indices(ygm::comm          &world,
+                                       const parameters_t &params,
+                                       const int           trial) {
   std::vector<uint64_t> indices;
-  indices.reserve(local_updates);
-  uint64_t global_table_size = ((uint64_t)1) << log_table_size;
-
-  if (dist == parameters_t::distribution::uniform) {
-    std::mt19937 gen(world.size() * trial + world.rank());
-    std::uniform_int_distribution<uint64_t> dist(0, global_table_size - 1);
-    for (int64_t i = 0; i < local_updates; ++i) {
-      indices.push_back(dist(gen));
+  uint64_t global_table_size = ((uint64_t)1) << params.log_table_size;
+
+  if (params.dist == parameters_t::distribution::uniform) {
+    if (params.rng == rmat_rng::counter) {
+      // Insertion i of the global sequence depends only on (trial, i)
+      indices.resize(params.local_updates);
+      uint64_t first_index = params.first_update;
+      parallel_for_blocks(
+          params.num_threads, indices.size(),
+          [&indices, first_index, global_table_size, trial](
+              const uint64_t begin, const uint64_t end) {
+            for (uint64_t i = begin; i < end; ++i) {
+              indices[i] = counter_uniform_index(trial, first_index + i,
+                                                 global_table_size);
+            }
+          });
+    } else {
+      indices.reserve(params.local_updates);
+      std::mt19937 gen(world.size() * trial + world.rank());
+      std::uniform_int_distribution<uint64_t> dist(0, global_table_size - 1);
+      for (int64_t i = 0; i < params.local_updates; ++i) {
+        indices.push_back(dist(gen));
+      }
     }
-  } else if (dist == parameters_t::distribution::rmat) {
-    distributed_rmat_edge_generator rmat(
-        world, log_table_size, local_updates * world.size() / 2, trial);
+  } else if (params.dist == parameters_t::distribution::rmat) {
+    auto rmat = make_rmat_generator(world, params, trial);
 
-    rmat.for_all([&indices](const auto first, const auto second) {
-      indices.push_back(first);
-      indices.push_back(second);
-    });
+    indices = generate_edge_indices(rmat, params.num_threads,
+                                    params.rmat.undirected);
+  } else if (params.dist == parameters_t::distribution::synthetic) {
+    distributed_synthetic_edge_generator gen(
+        world, params.graph, params.log_table_size,
+        params.global_updates / 2, trial, params.graph_options);
+
+    indices = generate_edge_indices(gen, params.num_threads, false);
   }
 
   world.barrier();
@@ -124,19 +503,344 @@ std::vector<uint64_t> generate_indices(ygm::comm     &world,
   return indices;
 }
 
+// Calls fn on the same insertions generate_indices() returns, in the same
+// order, without storing them
+template <typename Function>
+void for_all_indices(ygm::comm &world, const parameters_t &params,
+                     const int trial, Function fn) {
+  uint64_t global_table_size = ((uint64_t)1) << params.log_table_size;
+
+  if (params.dist == parameters_t::distribution::uniform) {
+    if (params.rng == rmat_rng::counter) {
+      uint64_t first_index = params.first_update;
+      for (int64_t i = 0; i < params.local_updates; ++i) {
+        fn(counter_uniform_index(trial, first_index + i, global_table_size));
+      }
+    } else {
+      std::mt19937 gen(world.size() * trial + world.rank());
+      std::uniform_int_distribution<uint64_t> dist(0, global_table_size - 1);
+      for (int64_t i = 0; i < params.local_updates; ++i) {
+        fn(dist(gen));
+      }
+    }
+  } else if (params.dist == parameters_t::distribution::rmat) {
+    auto rmat = make_rmat_generator(world, params, trial);
+
+    rmat.for_all([&fn](const auto first, const auto second) {
+      fn(first);
+      fn(second);
+    });
+  } else if (params.dist == parameters_t::distribution::synthetic) {
+    distributed_synthetic_edge_generator gen(
+        world, params.graph, params.log_table_size,
+        params.global_updates / 2, trial, params.graph_options);
+
+    gen.for_all([&fn](const auto first, const auto second) {
+      fn(first);
+      fn(second);
+    });
+  }
+}
+
+// Calls process(batch) on the insertions of for_all_indices() params.batch_size
+// at a time.  With collective set, every rank makes the same number of calls,
+// so process may call collectives.  Returns the number of batches.
+template <typename Function>
+uint64_t for_all_index_batches(ygm::comm &world, const parameters_t &params,
+                               const int trial, const bool collective,
+                               Function process) {
+  return for_all_batches<uint64_t>(
+      world, params.batch_size, collective,
+      [&world, &params, trial](auto fn) {
+        for_all_indices(world, params, trial, fn);
+      },
+      process);
+}
+
+// Calls fn on each of this trial's insertions as it is generated.  With -b,
+// insertions are generated a batch at a time, and with -q end_batch() and a
+// barrier follow each batch.  Returns the number of batches, 0 when unbatched.
+template <typename Function, typename EndBatch>
+uint64_t stream_indices(ygm::comm &world, const parameters_t &params,
+                        const int trial, Function fn, EndBatch end_batch) {
+  if (params.batch_size == 0) {
+    for_all_indices(world, params, trial, fn);
+    return 0;
+  }
+
+  return for_all_index_batches(
+      world, params, trial, params.batch_barrier,
+      [&world, &params, &fn, &end_batch](std::span<const uint64_t> batch) {
+        for (const auto index : batch) {
+          fn(index);
+        }
+        if (params.batch_barrier) {
+          end_batch();
+          world.barrier();
+        }
+      });
+}
+
+// Identifies everything that determines the insertions generated for a trial
+// other than the number of ranks
+std::string index_cache_key(const parameters_t &params, const int trial) {
+  std::string key = "histo";
+  if (params.dist == parameters_t::distribution::uniform) {
+    key += "_uniform";
+  } else if (params.dist == parameters_t::distribution::rmat) {
+    key += "_rmat";
+  } else {
+    key += "_" + synthetic_graph_key(params.graph, params.graph_options);
+  }
+  key += "_s" + std::to_string(params.log_table_size);
+  if (params.global_count) {
+    key += "_n" + std::to_string(params.global_updates);
+  } else {
+    key += "_i" + std::to_string(params.local_updates);
+  }
+  key += "_seed" + std::to_string(trial);
+  if (params.dist == parameters_t::distribution::rmat) {
+    key += "_" + rmat_parameters_key(params.rmat);
+  }
+  if (params.rng == rmat_rng::counter) {
+    key += "_counter";
+  }
+
+  return key;
+}
+
+// Empties cont between trials.  Arrays are restored to table_size zeroes.
+template <typename Container>
+void reset_container(Container &cont, const uint64_t table_size) {
+  cont.clear();
+  if constexpr (requires { cont.resize(table_size); }) {
+    cont.resize(table_size);
+  }
+}
+
+// Key and count types of a histogram container.  Indices and counts are
+// converted to these before they are sent, so they set the bytes per message.
+template <typename Container>
+struct histogram_traits;
+
+template <typename Count, typename Key>
+struct histogram_traits<ygm::container::array<Count, Key>> {
+  using key_type   = Key;
+  using count_type = Count;
+};
+
+template <typename Key, typename Count>
+struct histogram_traits<ygm::container::map<Key, Count>> {
+  using key_type   = Key;
+  using count_type = Count;
+};
+
+template <typename Key>
+struct histogram_traits<ygm::container::counting_set<Key>> {
+  using key_type   = Key;
+  using count_type = size_t;
+};
+
+template <typename Key, typename Count>
+struct histogram_traits<bulk_histogram<Key, Count>> {
+  using key_type   = Key;
+  using count_type = Count;
+};
+
+template <typename Container>
+void reduce_index(Container &cont, const uint64_t index) {
+  using key_type   = typename histogram_traits<Container>::key_type;
+  using count_type = typename histogram_traits<Container>::count_type;
+
+  const key_type key(index);
+  if constexpr (requires { cont.async_insert(key); }) {  // For counting_set
+    cont.async_insert(key);
+  } else if constexpr (ygm::container::detail::HasAsyncReduceWithoutReductionOp<
+                           Container>) {
+    cont.async_reduce(key, count_type(1));
+  } else {
+    cont.async_visit(key, [](const auto i, auto &v) { ++v; });
+  }
+}
+
+// Adds count to index with a single message
+template <typename Container>
+void reduce_index(Container &cont, const uint64_t index,
+                  const uint64_t count) {
+  using key_type   = typename histogram_traits<Container>::key_type;
+  using count_type = typename histogram_traits<Container>::count_type;
+
+  const key_type key(index);
+  if constexpr (requires { cont.async_insert(key); }) {
+    // counting_set has no counted insertion
+    for (uint64_t i = 0; i < count; ++i) {
+      cont.async_insert(key);
+    }
+  } else if constexpr (ygm::container::detail::HasAsyncReduceWithoutReductionOp<
+                           Container>) {
+    cont.async_reduce(key, count_type(count));
+  } else {
+    cont.async_visit(
+        key, [](const auto i, auto &v, const count_type c) { v += c; },
+        count_type(count));
+  }
+}
+
 template <typename Container>
-void run_reductions(ygm::comm &world, const std::vector<uint64_t> &indices,
+void run_reductions(ygm::comm &world, std::span<const uint64_t> indices,
                     Container &cont) {
   for (const auto &index : indices) {
-    if constexpr (ygm::container::detail::HasAsyncReduceWithoutReductionOp<
-                      Container>) {
-      cont.async_reduce(index, 1);
-    } else {  // For reducing_adapter
-      cont.async_visit(index, [](const auto i, auto &v) { ++v; });
+    reduce_index(cont, index);
+  }
+
+  world.barrier();
+}
+
+// Generates insertions and sends them immediately.  Returns the number of
+// batches.
+template <typename Container>
+uint64_t stream_reductions(ygm::comm &world, const parameters_t &params,
+                           const int trial, Container &cont) {
+  uint64_t num_batches = stream_indices(
+      world, params, trial,
+      [&cont](const uint64_t index) { reduce_index(cont, index); }, [] {});
+
+  world.barrier();
+
+  return num_batches;
+}
+
+struct combiner_stats {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t sent;
+  uint64_t batches;
+};
+
+// Insertions are merged by a local_combiner of params.combiner_capacity entries
+// and sent when evicted or flushed before the barrier
+template <typename Container>
+combiner_stats run_combined_reductions(ygm::comm                &world,
+                                       const parameters_t       &params,
+                                       const int                 trial,
+                                       std::span<const uint64_t> indices,
+                                       Container                &cont) {
+  auto combiner = make_local_combiner<uint64_t, uint64_t>(
+      params.combiner_capacity,
+      [&cont](const uint64_t index, const uint64_t count) {
+        reduce_index(cont, index, count);
+      });
+
+  uint64_t num_batches{0};
+  if (params.stream) {
+    num_batches = stream_indices(
+        world, params, trial,
+        [&combiner](const uint64_t index) { combiner.async_reduce(index, 1); },
+        [&combiner] { combiner.flush(); });
+  } else {
+    for (const auto &index : indices) {
+      combiner.async_reduce(index, 1);
+    }
+  }
+  combiner.flush();
+
+  world.barrier();
+
+  return {combiner.hits(), combiner.misses(), combiner.sent(), num_batches};
+}
+
+// Every s_hot_key_sample_stride-th insertion is sampled to find hot indices
+static constexpr uint64_t s_hot_key_sample_stride = 16;
+
+// Collectively finds params.num_hot_keys hot indices from a sample of this
+// trial's insertions
+std::vector<uint64_t> find_hot_indices(ygm::comm                &world,
+                                       const parameters_t       &params,
+                                       const int                 trial,
+                                       std::span<const uint64_t> indices) {
+  return find_hot_keys(
+      world, params.num_hot_keys, [&](auto add_sample) {
+        if (params.stream) {
+          uint64_t i{0};
+          for_all_indices(world, params, trial,
+                          [&add_sample, &i](const uint64_t index) {
+                            if (i++ % s_hot_key_sample_stride == 0) {
+                              add_sample(index);
+                            }
+                          });
+        } else {
+          for (uint64_t i = 0; i < indices.size();
+               i += s_hot_key_sample_stride) {
+            add_sample(indices[i]);
+          }
+        }
+      });
+}
+
+// Insertions of hot indices are counted locally and merged into cont after
+// all other insertions have been sent.  Returns the number of batches.
+template <typename Container>
+uint64_t run_replicated_reductions(ygm::comm                &world,
+                               const parameters_t       &params,
+                               const int                 trial,
+                               std::span<const uint64_t> indices,
+                               Container &cont, hot_key_table &hot) {
+  auto reduce = [&cont, &hot](const uint64_t index) {
+    if (!hot.add(index)) {
+      reduce_index(cont, index);
+    }
+  };
+
+  uint64_t num_batches{0};
+  if (params.stream) {
+    num_batches = stream_indices(world, params, trial, reduce, [] {});
+  } else {
+    for (const auto &index : indices) {
+      reduce(index);
     }
   }
 
+  hot.flush([&cont](const uint64_t index, const uint64_t count) {
+    reduce_index(cont, index, count);
+  });
+
   world.barrier();
+
+  return num_batches;
+}
+
+// Largest and mean number of insertions received by a rank of cont.  With
+// hot indices, each rank sends one merged insertion per hot index it
+// inserted instead of the individual insertions.
+template <typename Container>
+std::pair<uint64_t, double> insertion_receive_load(
+    ygm::comm &world, const parameters_t &params, const int trial,
+    std::span<const uint64_t> indices, const Container &cont,
+    const hot_key_table &hot = hot_key_table()) {
+  std::vector<uint64_t>        sent_to_rank(world.size());
+  std::unordered_set<uint64_t> hot_inserted;
+  auto count_insertion = [&sent_to_rank, &hot_inserted, &cont,
+                          &hot](const uint64_t index) {
+    if (hot.contains(index)) {
+      hot_inserted.insert(index);
+    } else {
+      ++sent_to_rank[container_owner(cont, index)];
+    }
+  };
+
+  if (params.stream) {
+    for_all_indices(world, params, trial, count_insertion);
+  } else {
+    for (const auto index : indices) {
+      count_insertion(index);
+    }
+  }
+
+  for (const auto index : hot_inserted) {
+    ++sent_to_rank[container_owner(cont, index)];
+  }
+
+  return receive_load(world, sent_to_rank);
 }
 
 template <typename Container>
@@ -151,45 +855,290 @@ void check_counts(ygm::comm &world, Container &cont, int64_t local_count) {
                      ygm::sum(local_count, world));
 }
 
-std::tuple<long long, long, long> memory_usage(ygm::comm &world) {
-  std::ifstream status("/proc/self/status");
-  std::string   line;
-  int32_t       memoryUsage = 0;
+// Runs all trials of the benchmark on cont, appending results to output
+template <typename Container>
+void run_trials(ygm::comm &world, const parameters_t &params, Container &cont,
+                memory_profile &memory, boost::json::object &output) {
+  constexpr bool is_bulk = is_bulk_histogram_v<Container>;
+
+  uint64_t global_table_size = ((uint64_t)1) << params.log_table_size;
+
+  memory.record("CONTAINER_INIT");
+
+  for (int trial = 0; trial < params.num_trials; ++trial) {
+    world.stats_reset();
+    reset_container(cont, global_table_size);
+
+    reset_peak_rss();
+
+    std::vector<uint64_t>         generated_indices;
+    mapped_binary_array<uint64_t> cached_indices;
+    double                        generation_time{0.0};
+    double                        load_time{0.0};
+    double                        load_rate{0.0};
+    double                        write_time{0.0};
+    bool                          cache_hit{false};
+    if (!params.stream) {
+      std::string cache_path;
+      if (!params.cache_dir.empty()) {
+        cache_path = binary_array_cache_path(world, params.cache_dir,
+                                             index_cache_key(params, trial));
+
+        world.barrier();
+        ygm::utility::timer load_timer{};
+
+        cache_hit = open_binary_array_cache(world, cache_path, cached_indices);
+
+        if (cache_hit) {
+          load_time = load_timer.elapsed();
+          load_rate = ygm::sum(cached_indices.size_bytes(), world) /
+                      load_time / (1000 * 1000 * 1000);
+        }
+      }
+
+      if (!cache_hit) {
+        ygm::utility::timer generation_timer{};
+        generated_indices = generate_indices(world, params, trial);
+        generation_time   = generation_timer.elapsed();
+
+        if (!cache_path.empty()) {
+          ygm::utility::timer write_timer{};
+
+          bool written = ygm::logical_and(
+              write_binary_array(
+                  cache_path, std::span<const uint64_t>(generated_indices)),
+              world);
+
+          write_time = write_timer.elapsed();
+          if (!written) {
+            world.cerr0() << "Failed to write insertion cache to "
+                          << params.cache_dir << std::endl;
+          }
+        }
+      }
+
+      memory.record("INPUT_GENERATED");
+    }
 
-  while (std::getline(status, line)) {
-    if (line.find("VmRSS") == 0) {
-      size_t pos = line.find(":");
-      if (pos != std::string::npos) {
-        memoryUsage = std::stol(line.substr(pos + 1));
+    std::span<const uint64_t> indices(generated_indices);
+    if (cache_hit) {
+      indices = cached_indices.data();
+    }
+
+    // The traffic combining saves is measured against an untimed pass
+    // sending every insertion on its own
+    int64_t uncombined_async_count{0};
+    int64_t uncombined_isend_bytes{0};
+    if constexpr (!is_bulk) {
+      if (params.use_reducing_adapter) {
+        world.barrier();
+        world.stats_reset();
+
+        if (params.stream) {
+          stream_reductions(world, params, trial, cont);
+        } else {
+          run_reductions(world, indices, cont);
+        }
+
+        uncombined_async_count = read_stat(world, "GLOBAL_ASYNC_COUNT");
+        uncombined_isend_bytes = read_stat(world, "GLOBAL_ISEND_BYTES");
+
+        reset_container(cont, global_table_size);
+        world.barrier();
+        world.stats_reset();
       }
     }
+
+    hot_key_table hot;
+    double        detection_time{0.0};
+    if (params.num_hot_keys > 0) {
+      world.barrier();
+      ygm::utility::timer detection_timer{};
+
+      hot = hot_key_table(find_hot_indices(world, params, trial, indices));
+
+      detection_time = detection_timer.elapsed();
+    }
+
+    double               trial_time;
+    double               trial_rate;
+    uint64_t             num_batches{0};
+    combiner_stats       combined{0, 0, 0, 0};
+    bulk_histogram_stats bulk{};
+    memory.start_sampling();
+    world.barrier();
+    if constexpr (is_bulk) {
+      ygm::utility::timer update_timer{};
+
+      if (params.batch_size > 0) {
+        // Each batch is one collective step
+        num_batches = for_all_index_batches(
+            world, params, trial, true,
+            [&cont, &bulk](std::span<const uint64_t> batch) {
+              bulk_histogram_stats step = cont.count(batch);
+              bulk.sort_time      += step.sort_time;
+              bulk.exchange_time  += step.exchange_time;
+              bulk.aggregate_time += step.aggregate_time;
+              bulk.sent_pairs     += step.sent_pairs;
+              bulk.sent_bytes     += step.sent_bytes;
+            });
+      } else {
+        bulk = cont.count(indices);
+      }
+
+      trial_time = update_timer.elapsed();
+      trial_rate = params.global_updates / trial_time / (1000 * 1000 * 1000);
+    } else if (params.use_reducing_adapter) {
+      ygm::utility::timer update_timer{};
+
+      combined = run_combined_reductions(world, params, trial, indices, cont);
+      num_batches = combined.batches;
+
+      trial_time = update_timer.elapsed();
+      trial_rate = params.global_updates / trial_time / (1000 * 1000 * 1000);
+    } else if (!hot.empty()) {
+      ygm::utility::timer update_timer{};
+
+      num_batches =
+          run_replicated_reductions(world, params, trial, indices, cont, hot);
+
+      trial_time = update_timer.elapsed();
+      trial_rate = params.global_updates / trial_time / (1000 * 1000 * 1000);
+    } else if (params.stream) {
+      ygm::utility::timer update_timer{};
+
+      num_batches = stream_reductions(world, params, trial, cont);
+
+      trial_time = update_timer.elapsed();
+      trial_rate = params.global_updates / trial_time / (1000 * 1000 * 1000);
+    } else {
+      world.barrier();
+      ygm::utility::timer update_timer{};
+
+      run_reductions(world, indices, cont);
+
+      trial_time = update_timer.elapsed();
+      trial_rate = params.global_updates / trial_time / (1000 * 1000 * 1000);
+    }
+
+    memory.record("KERNEL");
+
+    check_counts(world, cont, params.local_updates);
+
+    auto [max_receive_load, mean_receive_load] =
+        insertion_receive_load(world, params, trial, indices, cont, hot);
+
+    output["TIME"].as_array().emplace_back(trial_time);
+    output["INSERTS_PER_SECOND(BILLIONS)"].as_array().emplace_back(trial_rate);
+    output["GENERATION_TIME"].as_array().emplace_back(generation_time);
+    output["TIME_TO_SOLUTION"].as_array().emplace_back(
+        generation_time + load_time + detection_time + trial_time);
+    output["PEAK_RSS_KB"].as_array().emplace_back(
+        ygm::max(read_proc_status_kb("VmHWM"), world));
+    output["MAX_RANK_RECEIVE_LOAD"].as_array().emplace_back(max_receive_load);
+    output["RECEIVE_LOAD_IMBALANCE"].as_array().emplace_back(
+        max_receive_load / mean_receive_load);
+    if (params.batch_size > 0) {
+      output["NUM_BATCHES"].as_array().emplace_back(
+          ygm::max(num_batches, world));
+    }
+    if (params.num_hot_keys > 0) {
+      auto [unreplicated_max_load, unreplicated_mean_load] =
+          insertion_receive_load(world, params, trial, indices, cont);
+
+      output["HOT_KEYS_REPLICATED"].as_array().emplace_back(hot.size());
+      output["HOT_KEY_DETECTION_TIME"].as_array().emplace_back(detection_time);
+      output["UNREPLICATED_MAX_RANK_RECEIVE_LOAD"].as_array().emplace_back(
+          unreplicated_max_load);
+      output["RECEIVE_LOAD_REDUCTION"].as_array().emplace_back(
+          1.0 - double(max_receive_load) / unreplicated_max_load);
+    }
+    if constexpr (is_bulk) {
+      output["BULK_SORT_TIME"].as_array().emplace_back(
+          ygm::max(bulk.sort_time, world));
+      output["BULK_EXCHANGE_TIME"].as_array().emplace_back(
+          ygm::max(bulk.exchange_time, world));
+      output["BULK_AGGREGATE_TIME"].as_array().emplace_back(
+          ygm::max(bulk.aggregate_time, world));
+      output["BULK_SENT_PAIRS"].as_array().emplace_back(
+          ygm::sum(bulk.sent_pairs, world));
+      output["BULK_SENT_BYTES"].as_array().emplace_back(
+          ygm::sum(bulk.sent_bytes, world));
+    }
+    if (params.use_reducing_adapter) {
+      uint64_t hits        = ygm::sum(combined.hits, world);
+      uint64_t attempts    = hits + ygm::sum(combined.misses, world);
+      int64_t  async_count = read_stat(world, "GLOBAL_ASYNC_COUNT");
+      int64_t  isend_bytes = read_stat(world, "GLOBAL_ISEND_BYTES");
+
+      output["COMBINER_HIT_RATE"].as_array().emplace_back(
+          attempts > 0 ? double(hits) / attempts : 0.0);
+      output["COMBINER_SENT_UPDATES"].as_array().emplace_back(
+          ygm::sum(combined.sent, world));
+      output["UNCOMBINED_GLOBAL_ASYNC_COUNT"].as_array().emplace_back(
+          uncombined_async_count);
+      output["UNCOMBINED_GLOBAL_ISEND_BYTES"].as_array().emplace_back(
+          uncombined_isend_bytes);
+      output["ASYNC_COUNT_REDUCTION"].as_array().emplace_back(
+          uncombined_async_count > 0
+              ? 1.0 - double(async_count) / uncombined_async_count
+              : 0.0);
+      output["ISEND_BYTES_REDUCTION"].as_array().emplace_back(
+          uncombined_isend_bytes > 0
+              ? 1.0 - double(isend_bytes) / uncombined_isend_bytes
+              : 0.0);
+    }
+    if (!params.cache_dir.empty()) {
+      output["CACHE_HIT"].as_array().emplace_back(cache_hit);
+      output["CACHE_LOAD_TIME"].as_array().emplace_back(load_time);
+      output["CACHE_LOAD_GB_PER_SECOND"].as_array().emplace_back(load_rate);
+      output["CACHE_WRITE_TIME"].as_array().emplace_back(write_time);
+    }
+
+    parse_stats(world, output);
   }
+}
 
-  return std::make_tuple(ygm::sum((int64_t)memoryUsage, world),
-                         ygm::min(memoryUsage, world),
-                         ygm::max(memoryUsage, world));
+// Runs all trials on the container selected by params, with indices sent as
+// Key and counts as Count
+template <typename Key, typename Count>
+void run_histogram(ygm::comm &world, const parameters_t &params,
+                   memory_profile &memory, boost::json::object &output) {
+  uint64_t global_table_size = ((uint64_t)1) << params.log_table_size;
+
+  if (params.bulk) {
+    bulk_histogram<Key, Count> hist(world, global_table_size);
+    run_trials(world, params, hist, memory, output);
+  } else if (params.cont == parameters_t::container::array) {
+    ygm::container::array<Count, Key> arr(world, global_table_size);
+    run_trials(world, params, arr, memory, output);
+  } else if (params.cont == parameters_t::container::map) {
+    ygm::container::map<Key, Count> map(world);
+    run_trials(world, params, map, memory, output);
+  } else if (params.cont == parameters_t::container::counting_set) {
+    ygm::container::counting_set<Key> cset(world);
+    run_trials(world, params, cset, memory, output);
+  }
 }
 
 int main(int argc, char **argv) {
   {
     ygm::comm world(&argc, &argv);
 
-    auto mem = memory_usage(world);
-    world.cout0("Startup memory: ", std::get<0>(mem));
-
     parameters_t params = parse_cmd_line(argc, argv, world);
 
     uint64_t global_table_size = ((uint64_t)1) << params.log_table_size;
-    // ygm::container::array<uint64_t> arr(world, global_table_size);
-    ygm::container::map<uint64_t, size_t> arr(world, global_table_size);
-    mem = memory_usage(world);
-    world.cout0("Array initialized memory: ", std::get<0>(mem));
 
     boost::json::object output;
 
     output["NAME"]                         = "HISTO_YGM";
     output["TIME"]                         = boost::json::array();
     output["INSERTS_PER_SECOND(BILLIONS)"] = boost::json::array();
+    output["GENERATION_TIME"]              = boost::json::array();
+    output["TIME_TO_SOLUTION"]             = boost::json::array();
+    output["PEAK_RSS_KB"]                  = boost::json::array();
+    output["MAX_RANK_RECEIVE_LOAD"]        = boost::json::array();
+    output["RECEIVE_LOAD_IMBALANCE"]       = boost::json::array();
     output["GLOBAL_ASYNC_COUNT"]           = boost::json::array();
     output["GLOBAL_ISEND_COUNT"]           = boost::json::array();
     output["GLOBAL_ISEND_BYTES"]           = boost::json::array();
@@ -197,73 +1146,110 @@ int main(int argc, char **argv) {
     output["MAX_WAITSOME_IALLREDUCE"]      = boost::json::array();
     output["COUNT_IALLREDUCE"]             = boost::json::array();
     output["TABLE_SIZE"]                   = global_table_size;
-    output["INSERTIONS"]       = params.local_updates * world.size();
-    output["REDUCING_ADAPTER"] = params.use_reducing_adapter;
+    output["INSERTIONS"]         = params.global_updates;
+    output["REDUCING_ADAPTER"]   = params.use_reducing_adapter;
+    if (params.num_hot_keys > 0) {
+      output["HOT_KEYS_REQUESTED"]                 = params.num_hot_keys;
+      output["HOT_KEY_SAMPLE_STRIDE"]              = s_hot_key_sample_stride;
+      output["HOT_KEYS_REPLICATED"]                = boost::json::array();
+      output["HOT_KEY_DETECTION_TIME"]             = boost::json::array();
+      output["UNREPLICATED_MAX_RANK_RECEIVE_LOAD"] = boost::json::array();
+      output["RECEIVE_LOAD_REDUCTION"]             = boost::json::array();
+    }
+    if (params.use_reducing_adapter) {
+      output["COMBINER_CAPACITY"] =
+          std::bit_ceil(std::max<uint64_t>(params.combiner_capacity, 1));
+      output["COMBINER_HIT_RATE"]             = boost::json::array();
+      output["COMBINER_SENT_UPDATES"]         = boost::json::array();
+      output["UNCOMBINED_GLOBAL_ASYNC_COUNT"] = boost::json::array();
+      output["UNCOMBINED_GLOBAL_ISEND_BYTES"] = boost::json::array();
+      output["ASYNC_COUNT_REDUCTION"]         = boost::json::array();
+      output["ISEND_BYTES_REDUCTION"]         = boost::json::array();
+    }
+    output["RANK_INVARIANT"] =
+        params.rng == rmat_rng::counter && params.global_count;
+    output["GENERATION_THREADS"] = params.num_threads;
+    output["STREAM"]             = params.stream;
+    if (params.batch_size > 0) {
+      output["BATCH_SIZE"]    = params.batch_size;
+      output["BATCH_BARRIER"] = params.batch_barrier;
+      output["NUM_BATCHES"]   = boost::json::array();
+    }
+    if (!params.cache_dir.empty()) {
+      output["CACHE_DIR"]                = params.cache_dir;
+      output["CACHE_HIT"]                = boost::json::array();
+      output["CACHE_LOAD_TIME"]          = boost::json::array();
+      output["CACHE_LOAD_GB_PER_SECOND"] = boost::json::array();
+      output["CACHE_WRITE_TIME"]         = boost::json::array();
+    }
     if (params.dist == parameters_t::distribution::uniform) {
       output["GENERATOR"] = "UNIFORM";
     } else if (params.dist == parameters_t::distribution::rmat) {
-      output["GENERATOR"] = "RMAT";
+      output["GENERATOR"]       = "RMAT";
+      output["RMAT_A"]          = params.rmat.a;
+      output["RMAT_B"]          = params.rmat.b;
+      output["RMAT_C"]          = params.rmat.c;
+      output["RMAT_D"]          = params.rmat.d;
+      output["RMAT_SCRAMBLER"]  = rmat_scrambler_name(params.rmat);
+      output["RMAT_UNDIRECTED"] = params.rmat.undirected;
+    } else if (params.dist == parameters_t::distribution::synthetic) {
+      output["GENERATOR"] = synthetic_graph_name(params.graph);
+      if (params.graph == synthetic_graph::zipf) {
+        output["ZIPF_EXPONENT"] = params.graph_options.zipf_exponent;
+      } else if (params.graph == synthetic_graph::chung_lu) {
+        output["POWER_LAW_EXPONENT"] = params.graph_options.power_law_exponent;
+      } else if (params.graph == synthetic_graph::block_local) {
+        output["LOCAL_FRACTION"] = params.graph_options.local_fraction;
+      }
     } else {
       output["GENERATOR"] = "UNKNOWN";
     }
+    if (params.bulk) {
+      output["CONTAINER"]           = "BULK_SYNCHRONOUS";
+      output["BULK_SORT_TIME"]      = boost::json::array();
+      output["BULK_EXCHANGE_TIME"]  = boost::json::array();
+      output["BULK_AGGREGATE_TIME"] = boost::json::array();
+      output["BULK_SENT_PAIRS"]     = boost::json::array();
+      output["BULK_SENT_BYTES"]     = boost::json::array();
+    } else if (params.cont == parameters_t::container::array) {
+      output["CONTAINER"] = "ARRAY";
+    } else if (params.cont == parameters_t::container::map) {
+      output["CONTAINER"] = "MAP";
+    } else if (params.cont == parameters_t::container::counting_set) {
+      output["CONTAINER"] = "COUNTING_SET";
+    } else {
+      output["CONTAINER"] = "UNKNOWN";
+    }
 
-    parse_welcome(world, output);
-
-    for (int trial = 0; trial < params.num_trials; ++trial) {
-      world.stats_reset();
-      arr.clear();
-      // arr.resize(global_table_size);
-
-      std::vector<uint64_t> indices =
-          generate_indices(world, params.local_updates, params.log_table_size,
-                           trial, params.dist);
-
-      mem = memory_usage(world);
-      world.cout0("Memory with indices: ", std::get<0>(mem));
-
-      double trial_time;
-      double trial_rate;
-      world.barrier();
-      if (params.use_reducing_adapter) {
-        /*
-        auto reducing_arr = ygm::container::detail::make_reducing_adapter(
-            arr, [](const uint64_t &a, const uint64_t &b) { return a + b; });
-
-        world.barrier();
-
-        ygm::utility::timer update_timer{};
-
-        run_reductions(world, indices, reducing_arr);
-
-        trial_time = update_timer.elapsed();
-        trial_rate = params.local_updates * world.size() / trial_time /
-                     (1000 * 1000 * 1000);
-                     */
-      } else {
-        world.barrier();
-        ygm::utility::timer update_timer{};
-
-        run_reductions(world, indices, arr);
+    // Indices of tables of fewer than 2^32 entries and counts of up to 2^32
+    // insertions are sent as 32-bit values unless -W 64 is given
+    bool narrow_keys =
+        params.word_bits == 32 ||
+        (params.word_bits == 0 && params.log_table_size < 32);
+    bool narrow_counts =
+        params.word_bits == 32 ||
+        (params.word_bits == 0 &&
+         uint64_t(params.global_updates) <= UINT32_MAX);
 
-        trial_time = update_timer.elapsed();
-        trial_rate = params.local_updates * world.size() / trial_time /
-                     (1000 * 1000 * 1000);
-      }
+    output["KEY_BITS"]   = narrow_keys ? 32 : 64;
+    output["COUNT_BITS"] = narrow_counts ? 32 : 64;
 
-      mem = memory_usage(world);
-      world.cout0("Memory after increments: ", std::get<0>(mem));
-
-      check_counts(world, arr, params.local_updates);
+    parse_welcome(world, output);
 
-      output["TIME"].as_array().emplace_back(trial_time);
-      output["INSERTS_PER_SECOND(BILLIONS)"].as_array().emplace_back(
-          trial_rate);
+    memory_profile memory(world.get_mpi_comm(), output);
+    memory.record("STARTUP");
 
-      parse_stats(world, output);
+    if (narrow_keys && narrow_counts) {
+      run_histogram<uint32_t, uint32_t>(world, params, memory, output);
+    } else if (narrow_keys) {
+      run_histogram<uint32_t, uint64_t>(world, params, memory, output);
+    } else if (narrow_counts) {
+      run_histogram<uint64_t, uint32_t>(world, params, memory, output);
+    } else {
+      run_histogram<uint64_t, uint64_t>(world, params, memory, output);
     }
 
-    mem = memory_usage(world);
-    world.cout0("Memory after trials: ", std::get<0>(mem));
+    memory.record("TEARDOWN");
 
     if (params.pretty_print) {
       pretty_print(world.cout0(), output);
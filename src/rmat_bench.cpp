@@ -0,0 +1,289 @@
+// Copyright 2019-2021 Lawrence Livermore National Security, LLC and other YGM
+// Project Developers. See the top-level COPYRIGHT file for details.
+//
+// SPDX-License-Identifier: MIT
+
+#include <memory_profile.hpp>
+#include <rmat_edge_generator.hpp>
+#include <utility.hpp>
+#include <ygm/collective.hpp>
+#include <ygm/comm.hpp>
+#include <ygm/utility/timer.hpp>
+
+#include <boost/json/src.hpp>
+
+struct parameters_t {
+  int             graph_scale;
+  int64_t         local_edges;
+  int             batch_size;
+  int             num_trials;
+  rmat_rng        rng;
+  rmat_parameters rmat;
+  bool            pretty_print;
+
+  parameters_t()
+      : graph_scale(20),
+        local_edges(1024 * 1024),
+        batch_size(4096),
+        num_trials(5),
+        rng(rmat_rng::sequential),
+        pretty_print(false) {}
+};
+
+void usage(ygm::comm &comm) {
+  comm.cerr0() << "rmat_bench usage:"
+               << "\n\t-g <int>\t- Log_2 of global number of vertices"
+               << "\n\t-e <int>\t- Number of edges generated per rank"
+               << "\n\t-b <int>\t- Number of edges per generate_batch() call"
+               << "\n\t-I\t\t- Use counter-based random number generation"
+               << "\n\t-S <str>\t- Vertex scrambler (none, hash, feistel)"
+               << "\n\t-t <int>\t- Number of trials"
+               << "\n\t-p\t\t- Pretty print output"
+               << "\n\t-h\t\t- Print help" << std::endl;
+}
+
+parameters_t parse_cmd_line(int argc, char **argv, ygm::comm &comm) {
+  parameters_t params;
+  int          c;
+  bool         prn_help = false;
+
+  // Suppress error messages from getopt
+  extern int opterr;
+  opterr = 0;
+
+  while ((c = getopt(argc, argv, "g:e:b:IS:t:ph")) != -1) {
+    switch (c) {
+      case 'h':
+        prn_help = true;
+        break;
+      case 'g':
+        params.graph_scale = atoi(optarg);
+        break;
+      case 'e':
+        params.local_edges = atoll(optarg);
+        break;
+      case 'b':
+        params.batch_size = atoi(optarg);
+        break;
+      case 'I':
+        params.rng = rmat_rng::counter;
+        break;
+      case 'S':
+        if (!parse_rmat_scrambler(optarg, params.rmat)) {
+          comm.cerr0() << "Unrecognized scrambler: " << optarg << std::endl;
+          prn_help = true;
+        }
+        break;
+      case 't':
+        params.num_trials = atoi(optarg);
+        break;
+      case 'p':
+        params.pretty_print = true;
+        break;
+      default:
+        comm.cerr0() << "Unrecognized option: " << char(optopt) << std::endl;
+        prn_help = true;
+        break;
+    }
+  }
+
+  if (params.local_edges < 0) {
+    comm.cerr0() << "Number of edges (-e) must not be negative" << std::endl;
+    prn_help = true;
+  }
+
+  if (params.batch_size < 1) {
+    comm.cerr0() << "Batch size (-b) must be positive" << std::endl;
+    prn_help = true;
+  }
+
+  if (params.graph_scale < 1 || params.graph_scale > 64) {
+    comm.cerr0() << "Graph scale (-g) must be between 1 and 64" << std::endl;
+    prn_help = true;
+  } else if (params.rmat.scramble &&
+             params.rmat.scrambler == rmat_scrambler::hash &&
+             params.graph_scale <= 16) {
+    comm.cerr0() << "The hash scrambler requires a graph scale (-g) above 16; "
+                    "use -S feistel or -S none"
+                 << std::endl;
+    prn_help = true;
+  }
+
+  if (prn_help) {
+    usage(comm);
+    exit(-1);
+  }
+
+  return params;
+}
+
+// Combines edges into a checksum so generation cannot be optimized away and
+// the scalar and batch paths can be compared
+inline uint64_t edge_checksum(const rmat_edge_generator::edge_type &edge) {
+  return splitmix64_mix(edge.first) ^ splitmix64_mix(~edge.second);
+}
+
+uint64_t run_scalar(const parameters_t &params, const uint64_t seed) {
+  rmat_edge_generator rmat(params.graph_scale, params.local_edges, seed,
+                           params.rmat.scramble, false, params.rmat.a,
+                           params.rmat.b, params.rmat.c, params.rmat.d,
+                           params.rng, params.rmat.scrambler);
+
+  uint64_t checksum{0};
+  for (int64_t i = 0; i < params.local_edges; ++i) {
+    checksum += edge_checksum(rmat.generate_single_edge());
+  }
+
+  return checksum;
+}
+
+uint64_t run_batch(const parameters_t &params, const uint64_t seed) {
+  rmat_edge_generator rmat(params.graph_scale, params.local_edges, seed,
+                           params.rmat.scramble, false, params.rmat.a,
+                           params.rmat.b, params.rmat.c, params.rmat.d,
+                           params.rng, params.rmat.scrambler);
+
+  std::vector<rmat_edge_generator::edge_type> batch(params.batch_size);
+
+  uint64_t checksum{0};
+  for (int64_t i = 0; i < params.local_edges; i += batch.size()) {
+    std::span<rmat_edge_generator::edge_type> edges(
+        batch.data(),
+        std::min<uint64_t>(batch.size(), params.local_edges - i));
+    rmat.generate_batch(edges);
+    for (const auto &edge : edges) {
+      checksum += edge_checksum(edge);
+    }
+  }
+
+  return checksum;
+}
+
+// Keeps scrambled vertices live so the timed loops are not optimized away
+static volatile uint64_t s_scramble_sink;
+
+template <typename Scrambler>
+void run_scrambler(const std::vector<uint64_t> &vertices, Scrambler scramble) {
+  uint64_t checksum{0};
+  for (const auto vertex : vertices) {
+    checksum += scramble(vertex);
+  }
+
+  s_scramble_sink = checksum;
+}
+
+int main(int argc, char **argv) {
+  {
+    ygm::comm world(&argc, &argv);
+
+    parameters_t params = parse_cmd_line(argc, argv, world);
+
+    uint64_t global_edges = params.local_edges * world.size();
+
+    boost::json::object output;
+
+    output["NAME"]                                      = "RMAT_BENCH";
+    output["SCALAR_TIME"]                               = boost::json::array();
+    output["BATCH_TIME"]                                = boost::json::array();
+    output["SCALAR_EDGES_PER_SECOND(MILLIONS)"]         = boost::json::array();
+    output["BATCH_EDGES_PER_SECOND(MILLIONS)"]          = boost::json::array();
+    output["BATCH_MATCHES_SCALAR"]                      = boost::json::array();
+    output["HASH_NBITS_SCRAMBLES_PER_SECOND(MILLIONS)"] = boost::json::array();
+    output["FEISTEL_SCRAMBLES_PER_SECOND(MILLIONS)"]    = boost::json::array();
+    output["GRAPH_SCALE"]                               = params.graph_scale;
+    output["EDGES"]                                     = global_edges;
+    output["BATCH_SIZE"]                                = params.batch_size;
+    if (params.rng == rmat_rng::counter) {
+      output["RNG"] = "COUNTER";
+    } else {
+      output["RNG"] = "SEQUENTIAL";
+    }
+    output["SCRAMBLER"] = rmat_scrambler_name(params.rmat);
+
+    parse_welcome(world, output);
+
+    memory_profile memory(world.get_mpi_comm(), output);
+    memory.record("STARTUP");
+
+    for (int trial = 0; trial < params.num_trials; ++trial) {
+      uint64_t seed = trial * world.size() + world.rank();
+
+      reset_peak_rss();
+      memory.start_sampling();
+      world.barrier();
+      ygm::utility::timer scalar_timer{};
+
+      uint64_t scalar_checksum = run_scalar(params, seed);
+
+      world.barrier();
+      double scalar_time = scalar_timer.elapsed();
+
+      ygm::utility::timer batch_timer{};
+
+      uint64_t batch_checksum = run_batch(params, seed);
+
+      world.barrier();
+      double batch_time = batch_timer.elapsed();
+      memory.record("KERNEL");
+
+      bool matches = ygm::logical_and(scalar_checksum == batch_checksum, world);
+
+      output["SCALAR_TIME"].as_array().emplace_back(scalar_time);
+      output["BATCH_TIME"].as_array().emplace_back(batch_time);
+      output["SCALAR_EDGES_PER_SECOND(MILLIONS)"].as_array().emplace_back(
+          global_edges / scalar_time / (1000 * 1000));
+      output["BATCH_EDGES_PER_SECOND(MILLIONS)"].as_array().emplace_back(
+          global_edges / batch_time / (1000 * 1000));
+      output["BATCH_MATCHES_SCALAR"].as_array().emplace_back(matches);
+
+      // Scramble the endpoints of every local edge with each scrambler
+      std::vector<uint64_t> vertices(2 * params.local_edges);
+      counter_random_stream stream(seed, 0);
+      for (auto &vertex : vertices) {
+        vertex = stream.next() >> (64 - params.graph_scale);
+      }
+      uint64_t global_vertices = vertices.size() * world.size();
+
+      // hash_nbits() only supports scales above 16
+      if (params.graph_scale > 16) {
+        world.barrier();
+        ygm::utility::timer hash_timer{};
+
+        run_scrambler(vertices, [&params](const uint64_t v) {
+          return hash_nbits(v, params.graph_scale);
+        });
+
+        world.barrier();
+        double hash_time = hash_timer.elapsed();
+
+        output["HASH_NBITS_SCRAMBLES_PER_SECOND(MILLIONS)"]
+            .as_array()
+            .emplace_back(global_vertices / hash_time / (1000 * 1000));
+      }
+
+      world.barrier();
+      ygm::utility::timer feistel_timer{};
+
+      run_scrambler(vertices, [&params](const uint64_t v) {
+        return feistel_nbits(v, params.graph_scale);
+      });
+
+      world.barrier();
+      double feistel_time = feistel_timer.elapsed();
+
+      output["FEISTEL_SCRAMBLES_PER_SECOND(MILLIONS)"].as_array().emplace_back(
+          global_vertices / feistel_time / (1000 * 1000));
+    }
+
+    memory.record("TEARDOWN");
+
+    if (params.pretty_print) {
+      pretty_print(world.cout0(), output);
+      world.cout0() << "\n";
+    } else {
+      world.cout0(output);
+    }
+  }
+
+  return 0;
+}
@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <rmat_edge_generator.hpp>
+#include <utility.hpp>
 #include <ygm/comm.hpp>
 
 int main(int argc, char **argv) {
@@ -35,5 +37,105 @@ int main(int argc, char **argv) {
 
   world.barrier();
 
+  world.cout0("\nShowing counter-based RMAT generator");
+  rmat_edge_generator counter_edge_gen(4, 10, 1234, true, false, 0.57, 0.19,
+                                       0.19, 0.05, rmat_rng::counter);
+  std::vector<rmat_edge_generator::edge_type> counter_edges;
+  if (world.rank0()) {
+    counter_edge_gen.for_all([&world, &counter_edges](const auto src,
+                                                      const auto dest) {
+      world.cout() << "src: " << src << " dest: " << dest << std::endl;
+      counter_edges.push_back(std::make_pair(src, dest));
+    });
+  }
+
+  world.barrier();
+
+  world.cout0("\nRandom access to edges [4, 8) matches for_all");
+  if (world.rank0()) {
+    uint64_t i = 4;
+    counter_edge_gen.generate_range(
+        4, 8, [&world, &counter_edges, &i](const auto src, const auto dest) {
+          YGM_ASSERT_RELEASE(counter_edges[i] == std::make_pair(src, dest));
+          world.cout() << "edge " << i << " src: " << src << " dest: " << dest
+                       << std::endl;
+          ++i;
+        });
+    YGM_ASSERT_RELEASE(counter_edge_gen.generate_edge_at(9) ==
+                       counter_edges[9]);
+  }
+
+  world.barrier();
+
+  world.cout0(
+      "\nChecking counter-based distributed RMAT generator matches a single "
+      "rank");
+  {
+    const uint64_t global_edges = 1000;
+
+    distributed_rmat_edge_generator invariant_edge_gen(
+        world, 18, global_edges, 1234, true, false, 0.57, 0.19, 0.19, 0.05,
+        rmat_rng::counter);
+
+    std::vector<rmat_edge_generator::edge_type> local_edges;
+    invariant_edge_gen.for_all([&local_edges](const auto src, const auto dest) {
+      local_edges.push_back(std::make_pair(src, dest));
+    });
+
+    auto all_edges = gather_vectors_rank_0(world, local_edges);
+
+    if (world.rank0()) {
+      std::vector<rmat_edge_generator::edge_type> distributed_edges;
+      for (const auto &rank_edges : all_edges) {
+        distributed_edges.insert(distributed_edges.end(), rank_edges.begin(),
+                                 rank_edges.end());
+      }
+
+      std::vector<rmat_edge_generator::edge_type> serial_edges;
+      rmat_edge_generator serial_edge_gen(18, global_edges, 1234, true, false,
+                                          0.57, 0.19, 0.19, 0.05,
+                                          rmat_rng::counter);
+      serial_edge_gen.for_all(
+          [&serial_edges](const auto src, const auto dest) {
+            serial_edges.push_back(std::make_pair(src, dest));
+          });
+
+      std::sort(distributed_edges.begin(), distributed_edges.end());
+      std::sort(serial_edges.begin(), serial_edges.end());
+      YGM_ASSERT_RELEASE(distributed_edges == serial_edges);
+      world.cout() << "Edge sets match on " << world.size() << " ranks"
+                   << std::endl;
+    }
+  }
+
+  world.barrier();
+
+  world.cout0("\nChecking Feistel scrambler is a bijection for all scales");
+  if (world.rank0()) {
+    for (int scale = 1; scale <= 20; ++scale) {
+      std::vector<bool> seen(uint64_t(1) << scale, false);
+      for (uint64_t i = 0; i < seen.size(); ++i) {
+        uint64_t scrambled = feistel_nbits(i, scale);
+        YGM_ASSERT_RELEASE(scrambled < seen.size() && !seen[scrambled]);
+        seen[scrambled] = true;
+      }
+    }
+    for (int scale = 1; scale <= 64; ++scale) {
+      counter_random_stream stream(scale, 0);
+      uint64_t mask = uint64_t(-1) >> (64 - scale);
+      for (int i = 0; i < 100000; ++i) {
+        uint64_t value     = stream.next() & mask;
+        uint64_t scrambled = feistel_nbits(value, scale);
+        YGM_ASSERT_RELEASE((scrambled & ~mask) == 0);
+        YGM_ASSERT_RELEASE(feistel_nbits_inverse(scrambled, scale) == value);
+      }
+    }
+    world.cout() << "Exhaustively unique for scales 1-20, invertible for "
+                    "scales 1-64"
+                 << std::endl;
+  }
+
+  world.barrier();
+
   return 0;
 }